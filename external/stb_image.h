@@ -0,0 +1,3 @@
+// local stub for compile checks only
+#include <cstdlib>
+inline unsigned char* stbi_load(const char*, int* w, int* h, int*, int) { *w = *h = 0; return nullptr; }
@@ -0,0 +1,141 @@
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+
+#include "../Core/Camera.hpp"
+#include "../Core/Configuration.hpp"
+#include "../Core/Scenes.hpp"
+#include "../Integrators/BDPIntegrator.hpp"
+#include "../Integrators/MLTIntegrator.hpp"
+#include "Benchmark.hpp"
+
+// Counts heap allocations per BDPT sample on the Cornell box: first with fresh paths and a fresh contribution list for
+// every sample, then with paths reused across samples, then for the connection stage (combinePaths) alone. Last, the
+// allocations and rate of MLT mutations on one chain.
+// Usage: ./allocation-benchmark [sampleCount]
+
+std::atomic<size_t> allocationCount(0);
+
+// Every replaceable form is defined so that no allocation and deallocation pair mixes ours with the library's. The
+// deallocation stays out of line: inlined, g++ sees free() on a pointer from operator new (-Wmismatched-new-delete).
+void* operator new(size_t size) {
+  allocationCount.fetch_add(1, std::memory_order_relaxed);
+  if (void* pointer = std::malloc(size ? size : 1)) return pointer;
+  throw std::bad_alloc();
+}
+void* operator new[](size_t size) { return operator new(size); }
+[[gnu::noinline]] void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete[](void* pointer) noexcept { operator delete(pointer); }
+void operator delete(void* pointer, size_t) noexcept { operator delete(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { operator delete(pointer); }
+
+// Exposes the scratch paths of the integrator's workers.
+class BenchmarkIntegrator : public BDPTIntegrator {
+ public:
+  using BDPTIntegrator::BDPTIntegrator;
+  using BDPTIntegrator::PathArena;
+  int getMaxEvents() const { return maxEvents; }
+};
+
+struct Measurement {
+  size_t allocations = 0;
+  double seconds = 0;
+  double sum = 0;
+};
+
+// Exposes a single chain of the MLT integrator.
+class BenchmarkMLTIntegrator : public MLTIntegrator {
+ public:
+  using MLTIntegrator::MLTIntegrator;
+
+  // Runs mutationCount mutations of the first chain, setting the chains up on the first call.
+  Measurement mutate(size_t mutationCount, Image& film) const {
+    if (chains.empty()) {
+      runBootstrap();
+      initializeChains();
+    }
+    auto ignoreProgress = [](size_t) {};
+    Measurement result;
+    result.seconds = Benchmark::measureSeconds([&]() {
+      const size_t allocationsBefore = allocationCount;
+      runChain(chains.front(), mutationCount, film, ignoreProgress);
+      result.allocations = allocationCount - allocationsBefore;
+    });
+    result.sum = chains.front().current.pathContribution.scalarContrib;
+    return result;
+  }
+};
+
+void report(const std::string& name, const Measurement& result, size_t sampleCount) {
+  std::cout << name << "\t" << double(result.allocations) / sampleCount << " allocations/sample\t"
+            << sampleCount / result.seconds / 1e3 << " ksamples/s\t(sum " << result.sum << ")" << std::endl;
+}
+
+template <typename SampleFunction>
+Measurement measure(size_t sampleCount, const Config& config, SampleFunction sample) {
+  Measurement result;
+  result.seconds = Benchmark::measureSeconds([&]() {
+    const size_t allocationsBefore = allocationCount;
+    for (size_t n = 0; n < sampleCount; n++) {
+      const size_t pixel = n % (config.imageWidth * config.imageHeight);
+      RNG rng = Random::pixelStream(pixel, n / (config.imageWidth * config.imageHeight));
+      result.sum += sample(pixel % config.imageWidth, pixel / config.imageWidth, rng);
+    }
+    result.allocations = allocationCount - allocationsBefore;
+  });
+  return result;
+}
+
+int main(int argc, char const* argv[]) {
+  const size_t sampleCount = argc > 1 ? std::stoul(argv[1]) : 100000;
+
+  Config config;
+  config.bounceLimit = 8;
+  Scene scene = Scenes::selectScene(6, config);
+  const Camera camera(config, 0.0, 1.0);
+  const BenchmarkIntegrator integrator(config, scene, camera);
+
+  std::cout << "\n" << sampleCount << " samples, bounce limit " << config.bounceLimit << std::endl;
+
+  const Measurement fresh = measure(sampleCount, config, [&](size_t i, size_t j, RNG& rng) {
+    const Path cameraPath = integrator.generateCameraPath(i, j, rng);
+    const Path lightPath = integrator.generateLightPath(rng);
+    return integrator.combinePaths(cameraPath, lightPath).scalarContrib;
+  });
+  report("Fresh paths", fresh, sampleCount);
+
+  BenchmarkIntegrator::PathArena arena(integrator.getMaxEvents());
+  const Measurement reused = measure(sampleCount, config, [&](size_t i, size_t j, RNG& rng) {
+    integrator.generateCameraPath(i, j, rng, arena.cameraPath);
+    integrator.generateLightPath(rng, arena.lightPath);
+    integrator.combinePaths(arena.cameraPath, arena.lightPath, arena.contribution);
+    return arena.contribution.scalarContrib;
+  });
+  report("Reused paths", reused, sampleCount);
+
+  // The connection stage alone, on paths traced beforehand (tracing is included in the time).
+  size_t connectionAllocations = 0;
+  const Measurement connection = measure(sampleCount, config, [&](size_t i, size_t j, RNG& rng) {
+    integrator.generateCameraPath(i, j, rng, arena.cameraPath);
+    integrator.generateLightPath(rng, arena.lightPath);
+    const size_t before = allocationCount;
+    integrator.combinePaths(arena.cameraPath, arena.lightPath, arena.contribution);
+    connectionAllocations += allocationCount - before;
+    return arena.contribution.scalarContrib;
+  });
+  std::cout << "combinePaths\t" << double(connectionAllocations) / sampleCount << " allocations/sample" << std::endl;
+
+  // The first run grows the chain's buffers, the second is the steady state.
+  config.bootstrapCount = 1000;
+  config.chainCount = 1;
+  const BenchmarkMLTIntegrator mlt(config, scene, camera);
+  Image film(config.imageHeight, config.imageWidth);
+  mlt.mutate(sampleCount, film);
+  const Measurement mutations = mlt.mutate(sampleCount, film);
+  std::cout << "MLT mutations\t" << double(mutations.allocations) / sampleCount << " allocations/mutation\t"
+            << sampleCount / mutations.seconds / 1e3 << " kmutations/s" << std::endl;
+
+  return reused.sum == fresh.sum && connection.sum == fresh.sum ? 0 : 1;
+}
@@ -0,0 +1,139 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../Core/BVHNode.hpp"
+#include "../Core/Camera.hpp"
+#include "../Core/Configuration.hpp"
+#include "../Core/LinearBVH.hpp"
+#include "../Core/Scenes.hpp"
+#include "../Core/Stopwatch.hpp"
+#include "Benchmark.hpp"
+
+// Compares closest hit queries of the pointer based BVHNode tree and the flattened LinearBVH on the final scene, then
+// the median and SAH builds of LinearBVH on its two large sub-scenes.
+// Usage: ./bvh-benchmark [rayCount]
+
+using Benchmark::report;
+using Benchmark::TraceResult;
+
+template <typename Accelerator>
+Accelerator buildFinalScene(double& buildSeconds) {
+  // Same seed for both variants, so both trees hold identical geometry.
+  Random::generator = RNG();
+  Scene scene = Scenes::finalScene<Accelerator>();
+
+  Stopwatch stopwatch;
+  stopwatch.start();
+  Accelerator accelerator(scene, 0.0, 1.0);
+  stopwatch.stop();
+  buildSeconds = stopwatch.getElapsedSeconds();
+  return accelerator;
+}
+
+template <typename Accelerator>
+TraceResult trace(const Accelerator& accelerator, const std::vector<Ray>& rays) {
+  TraceResult result;
+  SInteraction interaction;
+  result.seconds = Benchmark::measureSeconds([&]() {
+    for (const auto& ray : rays) {
+      if (accelerator.intersect(ray, 0.001, Math::infinity, interaction)) {
+        result.hits++;
+        result.tSum += interaction.t;
+      }
+    }
+  });
+  return result;
+}
+
+// Rays between random points of the scene's box, grown by half its extent on every side.
+std::vector<Ray> randomRaysAround(Scene& scene, size_t rayCount, RNG& rng) {
+  AABB box;
+  scene.computeBoundingBox(0, 1, box);
+  const Vector3 margin = 0.5 * (box.getMax() - box.getMin());
+  const Point3 min = box.getMin() - margin;
+  const Point3 max = box.getMax() + margin;
+
+  std::vector<Ray> rays;
+  rays.reserve(rayCount);
+  for (size_t i = 0; i < rayCount; i++) {
+    const Point3 origin(Random::range(rng, min.x, max.x), Random::range(rng, min.y, max.y),
+                        Random::range(rng, min.z, max.z));
+    const Point3 target(Random::range(rng, min.x, max.x), Random::range(rng, min.y, max.y),
+                        Random::range(rng, min.z, max.z));
+    rays.push_back(Ray(origin, (target - origin).normalized()));
+  }
+  return rays;
+}
+
+void compareSplitMethods(const std::string& name, Scene scene, size_t rayCount) {
+  RNG rng(2);
+  const std::vector<Ray> rays = randomRaysAround(scene, rayCount, rng);
+
+  std::cout << "\n" << name << " (" << scene.getObjects().size() << " objects)" << std::endl;
+  for (auto method : {BVHSplitMethod::Median, BVHSplitMethod::SAH}) {
+    BVHBuildOptions options;
+    options.splitMethod = method;
+
+    Stopwatch stopwatch;
+    stopwatch.start();
+    const LinearBVH bvh(scene, 0, 1, options);
+    stopwatch.stop();
+
+    const std::string methodName = method == BVHSplitMethod::SAH ? "SAH" : "Median";
+    std::cout << methodName << "\tbuild " << stopwatch.getElapsedSeconds() << "s\t" << bvh.getTree().computeStats()
+              << std::endl;
+    report(methodName, trace(bvh, rays), rayCount);
+  }
+}
+
+int main(int argc, char const* argv[]) {
+  const size_t rayCount = argc > 1 ? std::stoul(argv[1]) : 1000000;
+
+  Config config;
+  Scenes::selectScene(9, config);
+  Camera camera(config, 0.0, 1.0);
+
+  double nodeBuildSeconds, linearBuildSeconds;
+  const BVHNode nodeTree = buildFinalScene<BVHNode>(nodeBuildSeconds);
+  const LinearBVH linearTree = buildFinalScene<LinearBVH>(linearBuildSeconds);
+  std::cout << "Build\tBVHNode " << nodeBuildSeconds << "s\tLinearBVH " << linearBuildSeconds << "s" << std::endl;
+  std::cout << "LinearBVH nodes (top level): " << linearTree.getTree().getNodeCount() << std::endl;
+
+  // Coherent camera rays and incoherent rays between random points of the scene.
+  RNG rng(1);
+  std::vector<Ray> primaryRays, randomRays;
+  primaryRays.reserve(rayCount);
+  randomRays.reserve(rayCount);
+  for (size_t i = 0; i < rayCount; i++) {
+    primaryRays.push_back(camera.getRay(Point2(Random::fraction(rng), Random::fraction(rng)), rng));
+    const Point3 origin(Random::range(rng, -1000, 1000), Random::range(rng, 0, 600), Random::range(rng, -1000, 1000));
+    randomRays.push_back(Ray(origin, Random::unitVector(rng), Random::fraction(rng)));
+  }
+
+  std::cout << "\nPrimary rays" << std::endl;
+  const TraceResult nodePrimary = trace(nodeTree, primaryRays);
+  const TraceResult linearPrimary = trace(linearTree, primaryRays);
+  report("BVHNode", nodePrimary, rayCount);
+  report("LinearBVH", linearPrimary, rayCount);
+  std::cout << "Speedup: " << nodePrimary.seconds / linearPrimary.seconds << "x" << std::endl;
+
+  std::cout << "\nRandom rays" << std::endl;
+  const TraceResult nodeRandom = trace(nodeTree, randomRays);
+  const TraceResult linearRandom = trace(linearTree, randomRays);
+  report("BVHNode", nodeRandom, rayCount);
+  report("LinearBVH", linearRandom, rayCount);
+  std::cout << "Speedup: " << nodeRandom.seconds / linearRandom.seconds << "x" << std::endl;
+
+  // Media are never hit by intersect, so both trees must report exactly the same hits.
+  const long hitDifference = long(nodePrimary.hits + nodeRandom.hits) - long(linearPrimary.hits + linearRandom.hits);
+  std::cout << "\nHit count difference: " << hitDifference << std::endl;
+  if (hitDifference != 0) return 1;
+
+  Random::generator = RNG();
+  Scene ground = Scenes::boxGround();
+  Scene spheres = Scenes::sphereCluster();
+  compareSplitMethods("Ground boxes", ground, rayCount);
+  compareSplitMethods("Sphere cluster", spheres, rayCount);
+  return 0;
+}
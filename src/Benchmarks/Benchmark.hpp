@@ -0,0 +1,35 @@
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+#include "../Core/Stopwatch.hpp"
+
+// Scaffolding shared by the benchmark targets.
+namespace Benchmark {
+  // Outcome of a batch of ray queries. Two traversals of the same scene must agree on hits and, up to rounding, tSum.
+  struct TraceResult {
+    size_t hits = 0;
+    double tSum = 0;
+    double seconds = 0;
+  };
+
+  // Wall clock seconds of one call of work().
+  template <typename Work>
+  double measureSeconds(Work&& work) {
+    Stopwatch stopwatch;
+    stopwatch.start();
+    work();
+    stopwatch.stop();
+    return stopwatch.getElapsedSeconds();
+  }
+
+  inline void report(const std::string& name, const TraceResult& result, size_t rayCount) {
+    std::cout << name << "\t" << result.seconds << "s\t" << rayCount / result.seconds / 1e6 << " Mrays/s\t"
+              << result.hits << " hits" << std::endl;
+  }
+}
+
+#endif
@@ -0,0 +1,168 @@
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "../Core/Instance.hpp"
+#include "../Core/LinearBVH.hpp"
+#include "../Core/Scene.hpp"
+#include "../GeoObjects/Sphere.hpp"
+#include "../Materials/Lambertian.hpp"
+#include "Benchmark.hpp"
+
+// Scatters copies of the sphere cluster of the final scene (160 spheres) under random rotations, uniform scalings and
+// translations, once as instances of one shared LinearBVH under a top level LinearBVH, once as transformed copies of
+// every sphere in a single LinearBVH. Reports the heap memory and build time of both, closest hit throughput of random
+// rays, and exits with 1 if the two disagree on more grazing hits than Real's precision explains.
+// Usage: ./instance-benchmark [instanceCount] [rayCount]
+
+std::atomic<size_t> liveBytes(0);
+
+// Every block keeps its size in front of it, so deletes can give it back.
+constexpr size_t headerSize = alignof(std::max_align_t);
+
+void* operator new(size_t size) {
+  char* block = static_cast<char*>(std::malloc(size + headerSize));
+  if (!block) throw std::bad_alloc();
+  *reinterpret_cast<size_t*>(block) = size;
+  liveBytes.fetch_add(size, std::memory_order_relaxed);
+  return block + headerSize;
+}
+void operator delete(void* pointer) noexcept {
+  if (!pointer) return;
+  char* block = static_cast<char*>(pointer) - headerSize;
+  liveBytes.fetch_sub(*reinterpret_cast<size_t*>(block), std::memory_order_relaxed);
+  std::free(block);
+}
+void operator delete(void* pointer, size_t) noexcept { operator delete(pointer); }
+
+struct BuildResult {
+  std::shared_ptr<LinearBVH> bvh;
+  size_t bytes = 0;
+  double seconds = 0;
+};
+
+struct DistanceTrace {
+  std::vector<Real> hitDistances;  // infinity for misses
+  double seconds = 0;
+};
+
+BuildResult buildInstanced(const std::vector<Point3>& centers, Real radius, const std::vector<Transform>& transforms,
+                           const std::shared_ptr<Material>& material) {
+  BuildResult result;
+  const size_t bytesBefore = liveBytes;
+  result.seconds = Benchmark::measureSeconds([&]() {
+    // Scenes only gather objects for the build; they are gone before the memory is counted.
+    Scene asset;
+    for (const auto& center : centers) asset.add(std::make_shared<Sphere>(center, radius, material));
+    const auto assetBVH = std::make_shared<LinearBVH>(asset, 0, 1);
+
+    Scene instances;
+    for (const auto& transform : transforms) instances.add(std::make_shared<Instance>(assetBVH, transform));
+    result.bvh = std::make_shared<LinearBVH>(instances, 0, 1);
+  });
+  result.bytes = liveBytes - bytesBefore;
+  return result;
+}
+
+BuildResult buildFlattened(const std::vector<Point3>& centers, Real radius, const std::vector<Transform>& transforms,
+                           const std::vector<Real>& scales, const std::shared_ptr<Material>& material) {
+  BuildResult result;
+  const size_t bytesBefore = liveBytes;
+  result.seconds = Benchmark::measureSeconds([&]() {
+    Scene spheres;
+    for (size_t i = 0; i < transforms.size(); i++)
+      for (const auto& center : centers)
+        spheres.add(std::make_shared<Sphere>(transforms[i].applyToPoint(center), radius * scales[i], material));
+    result.bvh = std::make_shared<LinearBVH>(spheres, 0, 1);
+  });
+  result.bytes = liveBytes - bytesBefore;
+  return result;
+}
+
+DistanceTrace trace(const LinearBVH& bvh, const std::vector<Ray>& rays) {
+  DistanceTrace result;
+  result.hitDistances.reserve(rays.size());
+  SInteraction interaction;
+  result.seconds = Benchmark::measureSeconds([&]() {
+    for (const auto& ray : rays) {
+      const bool hit = bvh.intersect(ray, 0.001, Math::infinity, interaction);
+      result.hitDistances.push_back(hit ? interaction.t : Math::realInfinity);
+    }
+  });
+  return result;
+}
+
+void report(const std::string& name, const BuildResult& build, const DistanceTrace& traced) {
+  size_t hits = 0;
+  for (const Real t : traced.hitDistances) hits += t < Math::realInfinity;
+  std::cout << name << "\t" << build.bytes / (1024.0 * 1024.0) << " MiB\tbuild " << build.seconds << "s\t"
+            << traced.hitDistances.size() / traced.seconds / 1e6 << " Mrays/s\t" << hits << " hits" << std::endl;
+}
+
+int main(int argc, char const* argv[]) {
+  const size_t instanceCount = argc > 1 ? std::stoul(argv[1]) : 1000;
+  const size_t rayCount = argc > 2 ? std::stoul(argv[2]) : 1000000;
+  const Real radius = 10;
+  const Real worldSize = 4000;
+
+  RNG rng(1);
+  std::vector<Point3> centers;
+  for (int i = 0; i < 160; i++)
+    centers.push_back(Point3(Random::range(rng, 0, 165), Random::range(rng, 0, 165), Random::range(rng, 0, 165)));
+
+  std::vector<Transform> transforms;
+  std::vector<Real> scales;
+  for (size_t i = 0; i < instanceCount; i++) {
+    const Real scale = Random::range(rng, 0.5, 1.5);
+    const Vector3 offset(Random::range(rng, 0, worldSize), Random::range(rng, 0, worldSize),
+                         Random::range(rng, 0, worldSize));
+    transforms.push_back(Transform::translation(offset) * Transform::rotationZ(Random::range(rng, 0, 360)) *
+                         Transform::rotationY(Random::range(rng, 0, 360)) *
+                         Transform::rotationX(Random::range(rng, 0, 360)) * Transform::scaling(scale));
+    scales.push_back(scale);
+  }
+
+  const auto material = std::make_shared<Lambertian>(Color(.73, .73, .73));
+  const BuildResult instanced = buildInstanced(centers, radius, transforms, material);
+  const BuildResult flattened = buildFlattened(centers, radius, transforms, scales, material);
+
+  // Rays between random points of the world, grown by a tenth on every side.
+  std::vector<Ray> rays;
+  rays.reserve(rayCount);
+  for (size_t i = 0; i < rayCount; i++) {
+    const Point3 origin(Random::range(rng, -400, worldSize + 400), Random::range(rng, -400, worldSize + 400),
+                        Random::range(rng, -400, worldSize + 400));
+    const Point3 target(Random::range(rng, -400, worldSize + 400), Random::range(rng, -400, worldSize + 400),
+                        Random::range(rng, -400, worldSize + 400));
+    rays.push_back(Ray(origin, (target - origin).normalized()));
+  }
+
+  const DistanceTrace instancedTrace = trace(*instanced.bvh, rays);
+  const DistanceTrace flattenedTrace = trace(*flattened.bvh, rays);
+
+  std::cout << instanceCount << " instances of " << centers.size() << " spheres" << std::endl;
+  report("Instanced", instanced, instancedTrace);
+  report("Flattened", flattened, flattenedTrace);
+  std::cout << "Memory ratio: " << double(flattened.bytes) / instanced.bytes << "x" << std::endl;
+
+  // The instanced rays are transformed back and forth, so distances agree up to rounding; a ray grazing a sphere can
+  // hit in one and miss in the other. The sphere test's discriminant is off by about epsilon times the squared
+  // distance, so the share of such rays grows with epsilon * (worldSize / radius)^2: none in double, a few in 1000 in
+  // float.
+  const double mismatchTolerance = std::numeric_limits<Real>::epsilon() * (worldSize / radius) * (worldSize / radius);
+  size_t mismatches = 0;
+  for (size_t i = 0; i < rayCount; i++) {
+    const Real a = instancedTrace.hitDistances[i], b = flattenedTrace.hitDistances[i];
+    if (a == b) continue;
+    if (a == Math::realInfinity || b == Math::realInfinity || std::fabs(a - b) > 1e-3 * std::fmax(1, std::fmax(a, b)))
+      mismatches++;
+  }
+  std::cout << "Mismatched hits: " << mismatches << " (tolerance " << mismatchTolerance * rayCount << ")" << std::endl;
+  return mismatches > mismatchTolerance * rayCount ? 1 : 0;
+}
@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../Core/Camera.hpp"
+#include "../Core/Configuration.hpp"
+#include "../Core/Sampler.hpp"
+#include "../Core/Scenes.hpp"
+#include "../Materials/ShadingBatch.hpp"
+#include "Benchmark.hpp"
+
+// BSDF evaluation (albedo * brdf * pdf) at camera hits, through the virtual Material interface, through the material
+// variants one hit at a time, through the variants batched by material with ShadingBatch, and batched over a queue
+// already in material order. The hits are shuffled like a queue after a bounce, where neighbours rarely share a
+// material. Scene 1 (Lambertian, metal and glass spheres on a checker ground) has ~480 materials, the Cornell box 4.
+// Usage: ./material-dispatch-benchmark [hitCount] [repetitions] [scene]
+
+struct Hit {
+  Point3 point;
+  Vector3 normal;
+  UV uv;
+  Vector3 wi;
+  Vector3 wo;
+};
+
+struct DispatchResult {
+  double checksum = 0;
+  double seconds = 0;
+};
+
+template <typename Evaluate>
+DispatchResult run(const std::vector<Hit>& hits, size_t repetitions, Evaluate evaluate) {
+  std::vector<Color> values(hits.size());
+  DispatchResult result;
+  result.seconds = Benchmark::measureSeconds([&]() {
+    for (size_t r = 0; r < repetitions; r++) evaluate(values);
+  });
+  for (const auto& value : values) result.checksum += value.red + value.green + value.blue;
+  return result;
+}
+
+void report(const std::string& name, const DispatchResult& result, size_t evaluationCount) {
+  std::cout << name << "\t" << result.seconds / evaluationCount * 1e9 << " ns/hit\t(checksum " << result.checksum
+            << ")" << std::endl;
+}
+
+template <typename BSDF>
+Color evaluate(const BSDF& bsdf, const Hit& hit) {
+  const double f = bsdf.brdf(hit.wi, hit.normal, hit.wo) * bsdf.pdf(hit.wi, hit.normal, hit.wo);
+  return bsdf.getColor(hit.uv, hit.point) * f;
+}
+
+int main(int argc, char const* argv[]) {
+  const size_t hitCount = argc > 1 ? std::stoul(argv[1]) : 1000000;
+  const size_t repetitions = argc > 2 ? std::stoul(argv[2]) : 10;
+  const int sceneSelection = argc > 3 ? std::stoi(argv[3]) : 1;
+
+  Config config;
+  Scene scene = Scenes::selectScene(sceneSelection, config);
+  const Camera camera(config, 0.0, 1.0);
+  const Sampler sampler(config);
+  scene.commit();
+
+  std::vector<Hit> hits;
+  std::vector<uint32_t> materialIds;
+  hits.reserve(hitCount);
+  materialIds.reserve(hitCount);
+  RNG rng = Random::pixelStream(0);
+  for (size_t n = 0; hits.size() < hitCount && n < 4 * hitCount; n++) {
+    const size_t i = n % config.imageWidth, j = (n / config.imageWidth) % config.imageHeight;
+    const Ray ray = camera.getRay(sampler.getRandomSample(i, j, rng), rng);
+    SInteraction interaction;
+    if (!scene.intersect(ray, 0.001, Math::infinity, interaction)) continue;
+    const Vector3 wo = (interaction.normal + Random::vectorInUnitSphere(rng)).normalized();
+    hits.push_back(Hit{interaction.point, interaction.normal, interaction.uv, -ray.direction.normalized(), wo});
+    materialIds.push_back(scene.getMaterialId(*interaction.materialPtr));
+  }
+  // Queue order after a bounce, where neighbouring entries rarely share a material.
+  for (size_t i = hits.size() - 1; i > 0; i--) {
+    const size_t k = std::min<size_t>(Random::fraction(rng) * (i + 1), i);
+    std::swap(hits[i], hits[k]);
+    std::swap(materialIds[i], materialIds[k]);
+  }
+  const size_t evaluationCount = hits.size() * repetitions;
+  std::cout << "\n" << hits.size() << " hits on " << scene.getMaterialCount() << " materials, " << repetitions
+            << " repetitions" << std::endl;
+
+  const DispatchResult virtualCalls = run(hits, repetitions, [&](std::vector<Color>& values) {
+    for (size_t i = 0; i < hits.size(); i++) values[i] = evaluate(scene.getMaterialById(materialIds[i]), hits[i]);
+  });
+  const DispatchResult variantCalls = run(hits, repetitions, [&](std::vector<Color>& values) {
+    for (size_t i = 0; i < hits.size(); i++) values[i] = evaluate(scene.getMaterialVariant(materialIds[i]), hits[i]);
+  });
+  ShadingBatch batch;
+  const DispatchResult batched = run(hits, repetitions, [&](std::vector<Color>& values) {
+    batch.shade(scene.getMaterialVariants(), materialIds,
+                [&](const auto& bsdf, uint32_t index) { values[index] = evaluate(bsdf, hits[index]); });
+  });
+  // Hits moved into material order once, as a wavefront queue compacted by material would hold them, so the batches
+  // read contiguous memory.
+  batch.sort(scene.getMaterialCount(), materialIds);
+  std::vector<Hit> queuedHits;
+  std::vector<uint32_t> queuedIds;
+  for (const auto index : batch.getOrder()) {
+    queuedHits.push_back(hits[index]);
+    queuedIds.push_back(materialIds[index]);
+  }
+  const DispatchResult queued = run(queuedHits, repetitions, [&](std::vector<Color>& values) {
+    batch.shade(scene.getMaterialVariants(), queuedIds,
+                [&](const auto& bsdf, uint32_t index) { values[index] = evaluate(bsdf, queuedHits[index]); });
+  });
+
+  report("Virtual", virtualCalls, evaluationCount);
+  report("Variant", variantCalls, evaluationCount);
+  report("Batched", batched, evaluationCount);
+  report("Queued", queued, evaluationCount);
+  std::cout << "Speedup of variants over virtual calls: " << virtualCalls.seconds / variantCalls.seconds << "x"
+            << std::endl;
+
+  // The queued sum adds the same values in another order.
+  const double checksum = virtualCalls.checksum;
+  const bool queuedMatches = std::abs(queued.checksum - checksum) <= 1e-9 * std::abs(checksum);
+  return variantCalls.checksum == checksum && batched.checksum == checksum && queuedMatches ? 0 : 1;
+}
@@ -0,0 +1,74 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../Core/Camera.hpp"
+#include "../Core/Configuration.hpp"
+#include "../Core/Scenes.hpp"
+#include "../Integrators/BDPIntegrator.hpp"
+#include "Benchmark.hpp"
+
+// Cost of asking "is this vertex on a light?" the way BDPT's connection loop used to (dynamic_cast on the material)
+// versus the material flags and their copy in the vertex. Queries run over the vertices of traced Cornell box paths
+// in path order.
+// Usage: ./material-flag-benchmark [sampleCount] [repetitions]
+
+struct QueryResult {
+  size_t emissive = 0;
+  double seconds = 0;
+};
+
+template <typename Query>
+QueryResult run(const std::vector<Vertex>& vertices, size_t repetitions, Query isEmissive) {
+  QueryResult result;
+  result.seconds = Benchmark::measureSeconds([&]() {
+    for (size_t r = 0; r < repetitions; r++)
+      for (const auto& vertex : vertices) result.emissive += isEmissive(vertex);
+  });
+  return result;
+}
+
+void report(const std::string& name, const QueryResult& result, size_t queryCount) {
+  std::cout << name << "\t" << result.seconds / queryCount * 1e9 << " ns/query\t(" << result.emissive << " emissive)"
+            << std::endl;
+}
+
+int main(int argc, char const* argv[]) {
+  const size_t sampleCount = argc > 1 ? std::stoul(argv[1]) : 100000;
+  const size_t repetitions = argc > 2 ? std::stoul(argv[2]) : 20;
+
+  Config config;
+  Scene scene = Scenes::selectScene(6, config);
+  const Camera camera(config, 0.0, 1.0);
+  const BDPTIntegrator integrator(config, scene, camera);
+  scene.commit();
+
+  // Every vertex with a material.
+  std::vector<Vertex> vertices;
+  Path cameraPath(config.bounceLimit + 1), lightPath(config.bounceLimit + 1);
+  for (size_t n = 0; n < sampleCount; n++) {
+    RNG rng = Random::pixelStream(n);
+    integrator.generateCameraPath(n % config.imageWidth, (n / config.imageWidth) % config.imageHeight, rng,
+                                  cameraPath);
+    integrator.generateLightPath(rng, lightPath);
+    for (int i = 1; i < cameraPath.length(); i++) vertices.push_back(cameraPath[i]);
+    for (int i = 0; i < lightPath.length(); i++) vertices.push_back(lightPath[i]);
+  }
+  const size_t queryCount = vertices.size() * repetitions;
+  std::cout << "\n" << vertices.size() << " vertices from " << sampleCount << " samples, " << repetitions
+            << " repetitions" << std::endl;
+
+  const QueryResult cast = run(vertices, repetitions, [&](const Vertex& vertex) {
+    return dynamic_cast<const DiffuseLight*>(&scene.getMaterialById(vertex.materialId)) != nullptr;
+  });
+  const QueryResult material = run(
+      vertices, repetitions, [&](const Vertex& vertex) { return scene.getMaterialById(vertex.materialId).isEmissive(); });
+  const QueryResult inlineFlags = run(vertices, repetitions, [](const Vertex& vertex) { return vertex.isEmissive(); });
+
+  report("dynamic_cast", cast, queryCount);
+  report("Material flags", material, queryCount);
+  report("Vertex flags", inlineFlags, queryCount);
+  std::cout << "Speedup of vertex flags over dynamic_cast: " << cast.seconds / inlineFlags.seconds << "x" << std::endl;
+
+  return cast.emissive == material.emissive && cast.emissive == inlineFlags.emissive ? 0 : 1;
+}
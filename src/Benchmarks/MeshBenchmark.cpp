@@ -0,0 +1,192 @@
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "../Core/MeshLoader.hpp"
+#include "../Core/Stopwatch.hpp"
+#include "../Materials/Lambertian.hpp"
+#include "Benchmark.hpp"
+
+// Writes a subdivided icosahedron as OBJ (with vertex normals) and as binary PLY, loads both on one thread and on
+// every hardware thread, builds the mesh BVH, then traces rays. Rays from the center through every vertex and edge
+// midpoint must all hit: a single miss means a crack between triangles. Exits with 1 on a crack or if the two files
+// load to different meshes.
+// Usage: ./mesh-benchmark [subdivisions] [rayCount]
+
+struct Icosphere {
+  std::vector<Point3> positions;
+  std::vector<uint32_t> indices;
+};
+
+Icosphere makeIcosphere(int subdivisions) {
+  const double t = (1 + std::sqrt(5.0)) / 2;
+  Icosphere sphere;
+  for (const auto& p : {Point3(-1, t, 0), Point3(1, t, 0), Point3(-1, -t, 0), Point3(1, -t, 0), Point3(0, -1, t),
+                        Point3(0, 1, t), Point3(0, -1, -t), Point3(0, 1, -t), Point3(t, 0, -1), Point3(t, 0, 1),
+                        Point3(-t, 0, -1), Point3(-t, 0, 1)})
+    sphere.positions.push_back(p / Vector3(p.x, p.y, p.z).magnitude());
+  sphere.indices = {0, 11, 5, 0, 5,  1,  0,  1,  7,  0,  7, 10, 0, 10, 11, 1, 5, 9, 5, 11,
+                    4, 11, 10, 2, 10, 7, 6,  7,  1,  8,  3, 9, 4,  3,  4,  2, 3, 2, 6, 3,
+                    6, 8,  3,  8, 9,  4, 9,  5,  2,  4,  11, 6, 2, 10, 8,  6, 7, 9, 8, 1};
+
+  for (int level = 0; level < subdivisions; level++) {
+    std::unordered_map<uint64_t, uint32_t> midpoints;
+    auto midpoint = [&](uint32_t a, uint32_t b) {
+      const uint64_t key = uint64_t(std::min(a, b)) << 32 | std::max(a, b);
+      const auto found = midpoints.find(key);
+      if (found != midpoints.end()) return found->second;
+      const Point3 middle = 0.5 * (sphere.positions[a] + sphere.positions[b]);
+      sphere.positions.push_back(middle / Vector3(middle.x, middle.y, middle.z).magnitude());
+      midpoints[key] = sphere.positions.size() - 1;
+      return uint32_t(sphere.positions.size() - 1);
+    };
+    std::vector<uint32_t> indices;
+    for (size_t i = 0; i < sphere.indices.size(); i += 3) {
+      const uint32_t a = sphere.indices[i], b = sphere.indices[i + 1], c = sphere.indices[i + 2];
+      const uint32_t ab = midpoint(a, b), bc = midpoint(b, c), ca = midpoint(c, a);
+      indices.insert(indices.end(), {a, ab, ca, b, bc, ab, c, ca, bc, ab, bc, ca});
+    }
+    sphere.indices = std::move(indices);
+  }
+  return sphere;
+}
+
+// Normals equal positions on the unit sphere.
+void writeOBJ(const std::string& path, const Icosphere& sphere) {
+  std::FILE* file = std::fopen(path.c_str(), "w");
+  for (const auto& p : sphere.positions)
+    std::fprintf(file, "v %.9g %.9g %.9g\nvn %.9g %.9g %.9g\n", p.x, p.y, p.z, p.x, p.y, p.z);
+  for (size_t i = 0; i < sphere.indices.size(); i += 3)
+    std::fprintf(file, "f %u//%u %u//%u %u//%u\n", sphere.indices[i] + 1, sphere.indices[i] + 1,
+                 sphere.indices[i + 1] + 1, sphere.indices[i + 1] + 1, sphere.indices[i + 2] + 1,
+                 sphere.indices[i + 2] + 1);
+  std::fclose(file);
+}
+
+void writePLY(const std::string& path, const Icosphere& sphere) {
+  std::ofstream file(path, std::ios::binary);
+  file << "ply\nformat binary_little_endian 1.0\nelement vertex " << sphere.positions.size()
+       << "\nproperty float x\nproperty float y\nproperty float z\nproperty float nx\nproperty float ny\n"
+       << "property float nz\nelement face " << sphere.indices.size() / 3
+       << "\nproperty list uchar int vertex_indices\nend_header\n";
+  for (const auto& p : sphere.positions) {
+    const float values[6] = {float(p.x), float(p.y), float(p.z), float(p.x), float(p.y), float(p.z)};
+    file.write(reinterpret_cast<const char*>(values), sizeof(values));
+  }
+  for (size_t i = 0; i < sphere.indices.size(); i += 3) {
+    const uint8_t count = 3;
+    const int32_t triangle[3] = {int32_t(sphere.indices[i]), int32_t(sphere.indices[i + 1]),
+                                 int32_t(sphere.indices[i + 2])};
+    file.write(reinterpret_cast<const char*>(&count), 1);
+    file.write(reinterpret_cast<const char*>(triangle), sizeof(triangle));
+  }
+}
+
+size_t fileSize(const std::string& path) {
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  return file.tellg();
+}
+
+// Times parsing on the given threads, then the BVH build.
+std::shared_ptr<TriangleMesh> load(const std::string& path, unsigned threadCount,
+                                   const std::shared_ptr<Material>& material) {
+  Stopwatch stopwatch;
+  stopwatch.start();
+  MeshLoader::MeshData data;
+  const bool isOBJ = path.substr(path.size() - 3) == "obj";
+  if (!(isOBJ ? MeshLoader::readOBJ(path, data, threadCount) : MeshLoader::readPLY(path, data, threadCount)))
+    return nullptr;
+  stopwatch.stop();
+  const double parseSeconds = stopwatch.getElapsedSeconds();
+
+  stopwatch.start();
+  auto mesh = std::make_shared<TriangleMesh>(std::move(data.positions), std::move(data.indices), material,
+                                             std::move(data.normals), std::move(data.uvs));
+  stopwatch.stop();
+  std::cout << path << "\t" << threadCount << " threads\tparse " << parseSeconds << "s ("
+            << fileSize(path) / parseSeconds / (1024 * 1024) << " MiB/s, "
+            << mesh->getTriangleCount() / parseSeconds / 1e6 << " Mtris/s)\tBVH " << stopwatch.getElapsedSeconds()
+            << "s" << std::endl;
+  return mesh;
+}
+
+// Rays from the center through the given points; returns how many miss.
+size_t countLeaks(const TriangleMesh& mesh, const std::vector<Point3>& targets) {
+  size_t leaks = 0;
+  SInteraction interaction;
+  for (const auto& target : targets)
+    if (!mesh.intersect(Ray(Point3(0, 0, 0), target - Point3(0, 0, 0)), 0, Math::infinity, interaction)) leaks++;
+  return leaks;
+}
+
+int main(int argc, char const* argv[]) {
+  const int subdivisions = argc > 1 ? std::stoi(argv[1]) : 7;
+  const size_t rayCount = argc > 2 ? std::stoul(argv[2]) : 1000000;
+  const unsigned hardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+  const Icosphere sphere = makeIcosphere(subdivisions);
+  const std::string objPath = "mesh-benchmark.obj", plyPath = "mesh-benchmark.ply";
+  writeOBJ(objPath, sphere);
+  writePLY(plyPath, sphere);
+  std::cout << sphere.indices.size() / 3 << " triangles, " << sphere.positions.size() << " vertices" << std::endl;
+
+  const auto material = std::make_shared<Lambertian>(Color(.73, .73, .73));
+  std::shared_ptr<TriangleMesh> objMesh, plyMesh;
+  for (const unsigned threadCount : {1u, hardwareThreads}) {
+    objMesh = load(objPath, threadCount, material);
+    plyMesh = load(plyPath, threadCount, material);
+    if (hardwareThreads == 1) break;
+  }
+  std::remove(objPath.c_str());
+  std::remove(plyPath.c_str());
+  if (!objMesh || !plyMesh) return 1;
+  const bool sameMesh = objMesh->getTriangleCount() == plyMesh->getTriangleCount() &&
+                        objMesh->getVertexCount() == plyMesh->getVertexCount();
+
+  const size_t bytes = objMesh->getVertexCount() * (sizeof(Point3) + sizeof(Vector3)) +
+                       objMesh->getTriangleCount() * 3 * sizeof(uint32_t) +
+                       objMesh->getTree().getNodeCount() * sizeof(LinearBVHNode);
+  std::cout << "Mesh memory: " << double(bytes) / objMesh->getTriangleCount() << " bytes/triangle\t"
+            << objMesh->getTree().computeStats() << std::endl;
+
+  // Random rays through the unit cube around the sphere.
+  RNG rng(1);
+  std::vector<Ray> rays;
+  rays.reserve(rayCount);
+  for (size_t i = 0; i < rayCount; i++) {
+    const Point3 origin(Random::range(rng, -2, 2), Random::range(rng, -2, 2), Random::range(rng, -2, 2));
+    const Point3 target(Random::range(rng, -1, 1), Random::range(rng, -1, 1), Random::range(rng, -1, 1));
+    rays.push_back(Ray(origin, (target - origin).normalized()));
+  }
+  Benchmark::TraceResult closest;
+  SInteraction interaction;
+  closest.seconds = Benchmark::measureSeconds([&]() {
+    for (const auto& ray : rays) {
+      if (objMesh->intersect(ray, 0.001, Math::infinity, interaction)) {
+        closest.hits++;
+        closest.tSum += interaction.t;
+      }
+    }
+  });
+  Benchmark::report("Closest hit", closest, rayCount);
+
+  // Vertices and edge midpoints of the mesh as loaded: rays through them graze up to six triangles at once.
+  std::vector<Point3> vertexTargets = sphere.positions, edgeTargets;
+  for (size_t i = 0; i < sphere.indices.size(); i += 3) {
+    for (int k = 0; k < 3; k++) {
+      const Point3& a = sphere.positions[sphere.indices[i + k]];
+      const Point3& b = sphere.positions[sphere.indices[i + (k + 1) % 3]];
+      edgeTargets.push_back(0.5 * (a + b));
+    }
+  }
+  const size_t leaks = countLeaks(*objMesh, vertexTargets) + countLeaks(*objMesh, edgeTargets) +
+                       countLeaks(*plyMesh, vertexTargets) + countLeaks(*plyMesh, edgeTargets);
+  std::cout << "Rays through vertices and edges: " << 2 * (vertexTargets.size() + edgeTargets.size()) << ", "
+            << leaks << " missed" << std::endl;
+  return leaks == 0 && sameMesh ? 0 : 1;
+}
@@ -0,0 +1,169 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../Core/Camera.hpp"
+#include "../Core/Configuration.hpp"
+#include "../Core/LinearBVH.hpp"
+#include "../Core/Scenes.hpp"
+#include "../Math/RayPacket.hpp"
+#include "Benchmark.hpp"
+
+// Compares scalar and 4-wide packet traversal of coherent rays: camera rays with four samples per pixel, then shadow
+// rays from their hits to points on the ceiling light. Both modes must agree on every hit.
+// Usage: ./packet-benchmark [rayCount]
+
+using Benchmark::report;
+using Benchmark::TraceResult;
+
+// Rays are grouped in fours: either the samples of one pixel or the shadow rays of their hits.
+struct RaySet {
+  std::vector<Ray> rays;
+  std::vector<Real> tMax;
+};
+
+RaySet cameraRays(const Config& config, const Camera& camera, size_t rayCount, RNG& rng) {
+  RaySet set;
+  set.rays.reserve(rayCount);
+  for (size_t pixel = 0; set.rays.size() < rayCount; pixel++) {
+    const size_t i = pixel % config.imageWidth;
+    const size_t j = (pixel / config.imageWidth) % config.imageHeight;
+    for (int s = 0; s < RayPacket::size; s++) {
+      const double u = (i + Random::fraction(rng)) / config.imageWidth;
+      const double v = (j + Random::fraction(rng)) / config.imageHeight;
+      const Point2 sample(u, v);
+      set.rays.push_back(camera.getRay(sample, rng));
+      set.tMax.push_back(Math::realInfinity);
+    }
+  }
+  return set;
+}
+
+// Unnormalized rays from every camera hit to a point on the light, occluded if anything lies in (0.001, 0.999).
+RaySet shadowRays(const Scene& scene, const RaySet& cameraSet, const GeoObject& light, RNG& rng) {
+  RaySet set;
+  SInteraction interaction;
+  for (size_t first = 0; first < cameraSet.rays.size(); first += RayPacket::size) {
+    for (int lane = 0; lane < RayPacket::size; lane++) {
+      const Ray& ray = cameraSet.rays[first + lane];
+      if (scene.intersect(ray, 0.001, Math::infinity, interaction)) {
+        set.rays.push_back(Ray(interaction.point, light.samplePoint(rng) - interaction.point));
+        set.tMax.push_back(0.999);
+      } else {
+        // Keeps the grouping; the ray points away from the scene and never hits.
+        set.rays.push_back(Ray(ray.origin, -ray.direction));
+        set.tMax.push_back(0.0);
+      }
+    }
+  }
+  return set;
+}
+
+TraceResult intersectScalar(const Scene& scene, const RaySet& set) {
+  TraceResult result;
+  SInteraction interaction;
+  result.seconds = Benchmark::measureSeconds([&]() {
+    for (size_t i = 0; i < set.rays.size(); i++) {
+      if (scene.intersect(set.rays[i], 0.001, set.tMax[i], interaction)) {
+        result.hits++;
+        result.tSum += interaction.t;
+      }
+    }
+  });
+  return result;
+}
+
+TraceResult intersectPackets(const Scene& scene, const RaySet& set) {
+  TraceResult result;
+  SInteraction interactions[RayPacket::size];
+  result.seconds = Benchmark::measureSeconds([&]() {
+    for (size_t first = 0; first < set.rays.size(); first += RayPacket::size) {
+      RayPacket packet;
+      Real tMax[RayPacket::size];
+      for (int lane = 0; lane < RayPacket::size; lane++) {
+        packet.set(lane, set.rays[first + lane]);
+        tMax[lane] = set.tMax[first + lane];
+      }
+      const int hitMask = scene.intersectPacket(packet, packet.activeMask, 0.001, tMax, interactions);
+      for (int lane = 0; lane < RayPacket::size; lane++) {
+        if (!RayPacket::isSet(hitMask, lane)) continue;
+        result.hits++;
+        result.tSum += interactions[lane].t;
+      }
+    }
+  });
+  return result;
+}
+
+TraceResult occludedScalar(const Scene& scene, const RaySet& set) {
+  TraceResult result;
+  result.seconds = Benchmark::measureSeconds([&]() {
+    for (size_t i = 0; i < set.rays.size(); i++)
+      if (scene.occluded(set.rays[i], 0.001, set.tMax[i])) result.hits++;
+  });
+  return result;
+}
+
+TraceResult occludedPackets(const Scene& scene, const RaySet& set) {
+  TraceResult result;
+  result.seconds = Benchmark::measureSeconds([&]() {
+    for (size_t first = 0; first < set.rays.size(); first += RayPacket::size) {
+      RayPacket packet;
+      for (int lane = 0; lane < RayPacket::size; lane++) packet.set(lane, set.rays[first + lane]);
+      const int blockedMask = scene.occludedPacket(packet, packet.activeMask, 0.001, &set.tMax[first]);
+      for (int lane = 0; lane < RayPacket::size; lane++) result.hits += RayPacket::isSet(blockedMask, lane);
+    }
+  });
+  return result;
+}
+
+bool compare(const std::string& name, const RaySet& set, const TraceResult& scalar, const TraceResult& packet) {
+  std::cout << "\n" << name << std::endl;
+  report("Scalar", scalar, set.rays.size());
+  report("Packet", packet, set.rays.size());
+  std::cout << "Speedup: " << scalar.seconds / packet.seconds << "x" << std::endl;
+  const bool agree = scalar.hits == packet.hits && scalar.tSum == packet.tSum;
+  if (!agree) std::cout << "Scalar and packet results differ" << std::endl;
+  return agree;
+}
+
+bool run(const std::string& name, Scene& scene, const Config& config, const GeoObject& light, size_t rayCount) {
+  scene.commit();
+  const Camera camera(config, 0.0, 1.0);
+  RNG rng(1);
+  const RaySet primary = cameraRays(config, camera, rayCount, rng);
+  const RaySet shadow = shadowRays(scene, primary, light, rng);
+
+  std::cout << "\n== " << name << " (" << scene.getObjects().size() << " objects) ==" << std::endl;
+  const bool primaryAgrees =
+      compare("Camera rays", primary, intersectScalar(scene, primary), intersectPackets(scene, primary));
+  const bool shadowAgrees =
+      compare("Shadow rays", shadow, occludedScalar(scene, shadow), occludedPackets(scene, shadow));
+  return primaryAgrees && shadowAgrees;
+}
+
+int main(int argc, char const* argv[]) {
+  size_t rayCount = argc > 1 ? std::stoul(argv[1]) : 1000000;
+  rayCount -= rayCount % RayPacket::size;
+  auto lightMaterial = std::make_shared<DiffuseLight>(Color(7, 7, 7));
+
+  Config cornellConfig;
+  Scene cornell = Scenes::selectScene(6, cornellConfig);
+  const RectangleXZ cornellLight({213, 343, 227, 332}, 554, lightMaterial);
+  bool agree = run("Cornell box", cornell, cornellConfig, cornellLight, rayCount);
+
+  // Ground boxes and the sphere cluster of the final scene, without the media.
+  Config finalConfig;
+  Scenes::selectScene(9, finalConfig);
+  Random::generator = RNG();
+  Scene ground = Scenes::boxGround();
+  Scene spheres = Scenes::sphereCluster();
+  Scene boxesAndSpheres;
+  for (const auto& object : ground.getObjects()) boxesAndSpheres.add(object);
+  boxesAndSpheres.add(std::make_shared<Translate>(
+      std::make_shared<RotateY>(std::make_shared<LinearBVH>(spheres, 0.0, 1.0), 15), Vector3(-100, 270, 395)));
+  const RectangleXZ finalLight({123, 423, 147, 412}, 554, lightMaterial);
+  agree = run("Ground and spheres", boxesAndSpheres, finalConfig, finalLight, rayCount) && agree;
+
+  return agree ? 0 : 1;
+}
@@ -0,0 +1,86 @@
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../Core/Camera.hpp"
+#include "../Core/Configuration.hpp"
+#include "../Core/Image.hpp"
+#include "../Core/Scenes.hpp"
+#include "../Integrators/PathIntegrator.hpp"
+#include "Benchmark.hpp"
+
+// Noise of the path integrator on the Cornell box (scene 6) against a reference image, for BSDF sampling alone (the
+// old recursive tracer), with Russian roulette, and with Russian roulette and light sampling. Error is the RMS
+// difference per pixel channel; the mean radiance of every mode should match the reference up to noise.
+// Usage: ./path-convergence-benchmark [imageWidth] [referenceSamples] [maxSamples]
+
+struct Mode {
+  std::string name;
+  int rouletteDepth;
+  bool nextEventEstimation;
+};
+
+struct RenderResult {
+  std::vector<Color> pixels;
+  double seconds = 0;
+};
+
+RenderResult render(Config config, const Scene& scene, const Camera& camera, const Mode& mode, int samplesPerPixel) {
+  config.samplesPerPixel = samplesPerPixel;
+  config.rouletteDepth = mode.rouletteDepth;
+  config.nextEventEstimation = mode.nextEventEstimation;
+  const PathIntegrator integrator(config, scene, camera);
+
+  Image image(config.imageHeight, config.imageWidth);
+  RenderResult result;
+  result.seconds = Benchmark::measureSeconds([&]() { integrator.render(image); });
+  image.normalize(samplesPerPixel);
+  for (size_t i = 0; i < config.imageHeight * config.imageWidth; i++) result.pixels.push_back(image[i]);
+  return result;
+}
+
+double mean(const std::vector<Color>& pixels) {
+  double sum = 0;
+  for (const auto& pixel : pixels) sum += pixel.red + pixel.green + pixel.blue;
+  return sum / (3 * pixels.size());
+}
+
+double rmse(const std::vector<Color>& pixels, const std::vector<Color>& reference) {
+  double sum = 0;
+  for (size_t i = 0; i < pixels.size(); i++) {
+    const Color difference = pixels[i] - reference[i];
+    sum += difference.red * difference.red + difference.green * difference.green + difference.blue * difference.blue;
+  }
+  return std::sqrt(sum / (3 * pixels.size()));
+}
+
+int main(int argc, char const* argv[]) {
+  Config config;
+  Scene scene = Scenes::selectScene(6, config);
+  config.imageWidth = argc > 1 ? std::stoul(argv[1]) : 100;
+  config.imageHeight = config.imageWidth;
+  const int referenceSamples = argc > 2 ? std::stoi(argv[2]) : 1024;
+  const int maxSamples = argc > 3 ? std::stoi(argv[3]) : 64;
+  const Camera camera(config, 0.0, 1.0);
+
+  const std::vector<Mode> modes = {
+      {"BSDF sampling", 0, false}, {"Russian roulette", 3, false}, {"Roulette + lights", 3, true}};
+  const RenderResult reference = render(config, scene, camera, modes.back(), referenceSamples);
+
+  std::vector<std::string> lines;
+  for (const auto& mode : modes) {
+    for (int samples = 1; samples <= maxSamples; samples *= 4) {
+      const RenderResult result = render(config, scene, camera, mode, samples);
+      lines.push_back(mode.name + "\t" + std::to_string(samples) + " spp\tRMSE " +
+                      std::to_string(rmse(result.pixels, reference.pixels)) + "\tmean " +
+                      std::to_string(mean(result.pixels)) + "\t" + std::to_string(result.seconds) + " s");
+    }
+  }
+
+  std::cout << "\n\n" << config.imageWidth << "x" << config.imageHeight << ", bounce limit " << config.bounceLimit
+            << ", reference " << referenceSamples << " spp with light sampling (mean " << mean(reference.pixels)
+            << ", " << reference.seconds << " s)" << std::endl;
+  for (const auto& line : lines) std::cout << line << std::endl;
+  return 0;
+}
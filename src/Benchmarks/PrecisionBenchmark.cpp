@@ -0,0 +1,76 @@
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <type_traits>
+
+#include "../Core/Camera.hpp"
+#include "../Core/Configuration.hpp"
+#include "../Core/Image.hpp"
+#include "../Core/Scenes.hpp"
+#include "../Integrators/PathIntegrator.hpp"
+#include "Benchmark.hpp"
+
+// Renders the Cornell box (scene 6) with the path integrator and compares the single and double precision builds. The
+// float build writes its mean radiance per channel to meanFile; the double build reads it back and exits with 1 if a
+// channel differs by more than the tolerance. Both builds draw the same samples, so only precision separates them.
+// Usage: ./precision-benchmark-float meanFile && ./precision-benchmark meanFile
+
+const double tolerance = 2e-3;  // relative, per channel
+
+Color renderMean(double& seconds) {
+  Config config;
+  Scene scene = Scenes::selectScene(6, config);
+  config.imageWidth = 100;
+  config.imageHeight = 100;
+  config.samplesPerPixel = 16;
+  const Camera camera(config, 0.0, 1.0);
+  const PathIntegrator integrator(config, scene, camera);
+
+  Image image(config.imageHeight, config.imageWidth);
+  seconds = Benchmark::measureSeconds([&]() { integrator.render(image); });
+  image.normalize(config.samplesPerPixel);
+
+  Color sum(0, 0, 0);
+  const size_t pixelCount = config.imageHeight * config.imageWidth;
+  for (size_t i = 0; i < pixelCount; i++) sum += image[i];
+  return sum / double(pixelCount);
+}
+
+int main(int argc, char const* argv[]) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " meanFile" << std::endl;
+    return 1;
+  }
+  const bool singlePrecision = std::is_same<Real, float>::value;
+
+  double seconds;
+  const Color mean = renderMean(seconds);
+  std::cout << (singlePrecision ? "float" : "double") << "\t" << seconds << "s\tmean " << mean.red << " "
+            << mean.green << " " << mean.blue << std::endl;
+
+  if (singlePrecision) {
+    std::ofstream meanFile(argv[1]);
+    meanFile.precision(17);
+    meanFile << mean.red << " " << mean.green << " " << mean.blue << std::endl;
+    return meanFile ? 0 : 1;
+  }
+
+  std::ifstream meanFile(argv[1]);
+  Color floatMean;
+  if (!(meanFile >> floatMean.red >> floatMean.green >> floatMean.blue)) {
+    std::cerr << "ERROR: Could not read the float build's means from '" << argv[1] << "'." << std::endl;
+    return 1;
+  }
+  std::cout << "float\tmean " << floatMean.red << " " << floatMean.green << " " << floatMean.blue << std::endl;
+
+  const double doubleChannels[3] = {mean.red, mean.green, mean.blue};
+  const double floatChannels[3] = {floatMean.red, floatMean.green, floatMean.blue};
+  double worst = 0;
+  for (int channel = 0; channel < 3; channel++) {
+    const double difference = std::fabs(doubleChannels[channel] - floatChannels[channel]);
+    worst = std::fmax(worst, difference / std::fmax(doubleChannels[channel], 1e-12));
+  }
+  std::cout << "Largest relative difference: " << worst << " (tolerance " << tolerance << ")" << std::endl;
+  return worst <= tolerance ? 0 : 1;
+}
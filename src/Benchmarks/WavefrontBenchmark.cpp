@@ -0,0 +1,71 @@
+#include <iostream>
+#include <string>
+
+#include "../Core/Camera.hpp"
+#include "../Core/Configuration.hpp"
+#include "../Core/Image.hpp"
+#include "../Core/Scenes.hpp"
+#include "../Integrators/PathIntegrator.hpp"
+#include "../Integrators/WavefrontIntegrator.hpp"
+#include "Benchmark.hpp"
+
+// Path throughput of the depth-first path tracer versus the wavefront one on the final scene (scene 9: glass, metal,
+// textured and volumetric objects). The wavefront tracer has neither light sampling nor Russian roulette, so both are
+// turned off for PathIntegrator too and every path does the same work. Both estimate the same image from different
+// random numbers, so the mean radiance of the two should agree up to noise.
+// Usage: ./wavefront-benchmark [samplesPerPixel] [imageWidth] [threads]
+
+struct RenderResult {
+  double seconds = 0;
+  double meanRadiance = 0;
+};
+
+RenderResult render(const Integrator& integrator, const Config& config) {
+  Image image(config.imageHeight, config.imageWidth);
+  RenderResult result;
+  result.seconds = Benchmark::measureSeconds([&]() { integrator.render(image); });
+  image.normalize(config.samplesPerPixel);
+  const size_t pixelCount = config.imageHeight * config.imageWidth;
+  for (size_t i = 0; i < pixelCount; i++) result.meanRadiance += (image[i].red + image[i].green + image[i].blue) / 3;
+  result.meanRadiance /= pixelCount;
+  return result;
+}
+
+void report(const std::string& name, const RenderResult& result, size_t pathCount) {
+  std::cout << name << "\t" << result.seconds << " s\t" << pathCount / result.seconds / 1e6 << " Mpaths/s\t(mean "
+            << result.meanRadiance << ")" << std::endl;
+}
+
+int main(int argc, char const* argv[]) {
+  Config config;
+  Scene scene = Scenes::selectScene(9, config);
+  config.samplesPerPixel = argc > 1 ? std::stoi(argv[1]) : 4;
+  config.imageWidth = argc > 2 ? std::stoul(argv[2]) : 400;
+  config.imageHeight = config.imageWidth;
+  if (argc > 3) config.threadCount = std::stoul(argv[3]);
+  config.nextEventEstimation = false;
+  config.rouletteDepth = 0;
+  const Camera camera(config, 0.0, 1.0);
+
+  const PathIntegrator depthFirst(config, scene, camera);
+  const WavefrontIntegrator wavefront(config, scene, camera);
+  config.usePackets = true;
+  const PathIntegrator depthFirstPackets(config, scene, camera);
+  const WavefrontIntegrator wavefrontPackets(config, scene, camera);
+  const size_t pathCount = config.imageHeight * config.imageWidth * config.samplesPerPixel;
+  std::cout << "\n" << config.imageWidth << "x" << config.imageHeight << ", " << config.samplesPerPixel
+            << " spp, bounce limit " << config.bounceLimit << ", " << config.threadCount << " threads" << std::endl;
+
+  const RenderResult depthFirstResult = render(depthFirst, config);
+  const RenderResult wavefrontResult = render(wavefront, config);
+  const RenderResult depthFirstPacketResult = render(depthFirstPackets, config);
+  const RenderResult wavefrontPacketResult = render(wavefrontPackets, config);
+  std::cout << std::endl;
+  report("Depth-first", depthFirstResult, pathCount);
+  report("Wavefront", wavefrontResult, pathCount);
+  report("Depth-first, packets", depthFirstPacketResult, pathCount);
+  report("Wavefront, packets", wavefrontPacketResult, pathCount);
+  std::cout << "Speedup of wavefront: " << depthFirstResult.seconds / wavefrontResult.seconds << "x, with packets "
+            << depthFirstPacketResult.seconds / wavefrontPacketResult.seconds << "x" << std::endl;
+  return 0;
+}
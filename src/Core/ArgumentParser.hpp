@@ -6,7 +6,7 @@
 
 #include "Configuration.hpp"
 
-enum IntegratorType { Naive, Bidirectional, Metropolis };
+enum IntegratorType { Naive, Bidirectional, Metropolis, Wavefront };
 
 // TODO: --help, --integrator
 class ArgumentParser {
@@ -17,6 +17,19 @@ class ArgumentParser {
   const std::string sampleSpec = "spp";
   const std::string sceneSpec = "s";
   const std::string fileNameSpec = "o";
+  const std::string threadSpec = "t";
+  const std::string packetSpec = "p";
+  const std::string misSpec = "mis";
+  const std::string formatSpec = "f";
+  const std::string toneMapSpec = "tm";
+  const std::string passSpec = "n";
+  const std::string chainSpec = "c";
+  const std::string bootstrapSpec = "bs";
+  const std::string checkpointSpec = "ck";
+  const std::string resumeSpec = "r";
+  const std::string rouletteSpec = "rr";
+  const std::string neeSpec = "nee";
+  const std::string meshSpec = "m";
 
   // Verbose arguments
   const std::string argPrefixVer = "--";
@@ -25,15 +38,43 @@ class ArgumentParser {
   const std::string sampleSpecVer = "sample";
   const std::string sceneSpecVer = "scene";
   const std::string fileNameSpecVer = "output";
+  const std::string threadSpecVer = "threads";
+  const std::string packetSpecVer = "packets";
+  const std::string misSpecVer = "mis";
+  const std::string formatSpecVer = "format";
+  const std::string toneMapSpecVer = "tonemap";
+  const std::string passSpecVer = "passes";
+  const std::string chainSpecVer = "chains";
+  const std::string bootstrapSpecVer = "bootstrap";
+  const std::string checkpointSpecVer = "checkpoint";
+  const std::string resumeSpecVer = "resume";
+  const std::string rouletteSpecVer = "roulette";
+  const std::string neeSpecVer = "nee";
+  const std::string meshSpecVer = "mesh";
 
   bool isNumerical(std::string string);
   void checkIntegratorArgument(std::string);
+  void checkFormatArgument(std::string);
+  void checkMISArgument(std::string);
 
  public:
   ushort sceneSelection = 0;
   ushort samplesPerPixel = 0;
   ushort bounceLimit = 0;
+  ushort threadCount = 0;
+  bool usePackets = false;
+  ushort misPower = 0;
+  ImageFormat outputFormat = ImageFormat::PPM;
+  short toneMap = -1;  // -1: on for PPM only
+  ushort passCount = 0;
+  ushort chainCount = 0;
+  unsigned bootstrapCount = 0;
+  ushort checkpointInterval = 0;
+  std::string resumeFile = "";
+  short rouletteDepth = -1;  // -1: keep the default
+  short nextEventEstimation = -1;
   std::string fileName = "";
+  std::string meshFile = "";
   IntegratorType integratorType = IntegratorType::Bidirectional;
 
   void parse(int argc, const char* argv[]);
@@ -55,6 +96,25 @@ void ArgumentParser::checkIntegratorArgument(std::string token) {
     integratorType = IntegratorType::Bidirectional;
   else if (token.compare("mlt") == 0)
     integratorType = IntegratorType::Metropolis;
+  else if (token.compare("wavefront") == 0)
+    integratorType = IntegratorType::Wavefront;
+}
+
+void ArgumentParser::checkFormatArgument(std::string token) {
+  if (token.compare("ppm") == 0)
+    outputFormat = ImageFormat::PPM;
+  else if (token.compare("pfm") == 0)
+    outputFormat = ImageFormat::PFM;
+  else if (token.compare("hdr") == 0)
+    outputFormat = ImageFormat::HDR;
+}
+
+// Only the balance (1) and power (2) heuristics are offered.
+void ArgumentParser::checkMISArgument(std::string token) {
+  if (token.compare("1") == 0 || token.compare("2") == 0)
+    misPower = std::stoi(token);
+  else
+    std::cout << "MIS heuristic must be 1 (balance) or 2 (power), not " << token << "." << std::endl;
 }
 
 void ArgumentParser::parse(int argc, const char* argv[]) {
@@ -71,6 +131,32 @@ void ArgumentParser::parse(int argc, const char* argv[]) {
         if (isNumerical(nextToken)) sceneSelection = std::stoi(nextToken);
       } else if (token.substr(1).compare(fileNameSpec) == 0) {
         fileName = nextToken;
+      } else if (token.substr(1).compare(threadSpec) == 0) {
+        if (isNumerical(nextToken)) threadCount = std::stoi(nextToken);
+      } else if (token.substr(1).compare(packetSpec) == 0) {
+        if (isNumerical(nextToken)) usePackets = std::stoi(nextToken) != 0;
+      } else if (token.substr(1).compare(misSpec) == 0) {
+        checkMISArgument(nextToken);
+      } else if (token.substr(1).compare(formatSpec) == 0) {
+        checkFormatArgument(nextToken);
+      } else if (token.substr(1).compare(toneMapSpec) == 0) {
+        if (isNumerical(nextToken)) toneMap = std::stoi(nextToken) != 0;
+      } else if (token.substr(1).compare(passSpec) == 0) {
+        if (isNumerical(nextToken)) passCount = std::stoi(nextToken);
+      } else if (token.substr(1).compare(chainSpec) == 0) {
+        if (isNumerical(nextToken)) chainCount = std::stoi(nextToken);
+      } else if (token.substr(1).compare(bootstrapSpec) == 0) {
+        if (isNumerical(nextToken)) bootstrapCount = std::stoul(nextToken);
+      } else if (token.substr(1).compare(checkpointSpec) == 0) {
+        if (isNumerical(nextToken)) checkpointInterval = std::stoi(nextToken);
+      } else if (token.substr(1).compare(resumeSpec) == 0) {
+        resumeFile = nextToken;
+      } else if (token.substr(1).compare(rouletteSpec) == 0) {
+        if (isNumerical(nextToken)) rouletteDepth = std::stoi(nextToken);
+      } else if (token.substr(1).compare(neeSpec) == 0) {
+        if (isNumerical(nextToken)) nextEventEstimation = std::stoi(nextToken) != 0;
+      } else if (token.substr(1).compare(meshSpec) == 0) {
+        meshFile = nextToken;
       } else if (token.substr(1).compare(integratorSpec) == 0) {
         checkIntegratorArgument(nextToken);
       } else {
@@ -88,6 +174,32 @@ void ArgumentParser::parse(int argc, const char* argv[]) {
         if (isNumerical(nextToken)) sceneSelection = std::stoi(nextToken);
       } else if (token.substr(2).compare(fileNameSpecVer) == 0) {
         fileName = nextToken;
+      } else if (token.substr(2).compare(threadSpecVer) == 0) {
+        if (isNumerical(nextToken)) threadCount = std::stoi(nextToken);
+      } else if (token.substr(2).compare(packetSpecVer) == 0) {
+        if (isNumerical(nextToken)) usePackets = std::stoi(nextToken) != 0;
+      } else if (token.substr(2).compare(misSpecVer) == 0) {
+        checkMISArgument(nextToken);
+      } else if (token.substr(2).compare(formatSpecVer) == 0) {
+        checkFormatArgument(nextToken);
+      } else if (token.substr(2).compare(toneMapSpecVer) == 0) {
+        if (isNumerical(nextToken)) toneMap = std::stoi(nextToken) != 0;
+      } else if (token.substr(2).compare(passSpecVer) == 0) {
+        if (isNumerical(nextToken)) passCount = std::stoi(nextToken);
+      } else if (token.substr(2).compare(chainSpecVer) == 0) {
+        if (isNumerical(nextToken)) chainCount = std::stoi(nextToken);
+      } else if (token.substr(2).compare(bootstrapSpecVer) == 0) {
+        if (isNumerical(nextToken)) bootstrapCount = std::stoul(nextToken);
+      } else if (token.substr(2).compare(checkpointSpecVer) == 0) {
+        if (isNumerical(nextToken)) checkpointInterval = std::stoi(nextToken);
+      } else if (token.substr(2).compare(resumeSpecVer) == 0) {
+        resumeFile = nextToken;
+      } else if (token.substr(2).compare(rouletteSpecVer) == 0) {
+        if (isNumerical(nextToken)) rouletteDepth = std::stoi(nextToken);
+      } else if (token.substr(2).compare(neeSpecVer) == 0) {
+        if (isNumerical(nextToken)) nextEventEstimation = std::stoi(nextToken) != 0;
+      } else if (token.substr(2).compare(meshSpecVer) == 0) {
+        meshFile = nextToken;
       } else if (token.substr(1).compare(integratorSpecVer) == 0) {
         checkIntegratorArgument(nextToken);
       } else {
@@ -100,6 +212,24 @@ void ArgumentParser::parse(int argc, const char* argv[]) {
 void ArgumentParser::setConfig(Config& config) {
   if (bounceLimit != 0) config.bounceLimit = bounceLimit;
   if (samplesPerPixel != 0) config.samplesPerPixel = samplesPerPixel;
+  if (threadCount != 0) config.threadCount = threadCount;
+  config.usePackets = usePackets;
+  if (misPower != 0) config.misPower = misPower;
+  config.outputFormat = outputFormat;
+  if (passCount != 0) config.passCount = passCount;
+  if (chainCount != 0) config.chainCount = chainCount;
+  if (bootstrapCount != 0) config.bootstrapCount = bootstrapCount;
+  config.checkpointInterval = checkpointInterval;
+  // Checkpoints are written between passes, so a single pass is split into passes of one sample each.
+  if (config.checkpointInterval > 0 && config.passCount == 1) {
+    config.passCount = config.samplesPerPixel;
+    config.samplesPerPixel = 1;
+  }
+  config.checkpointFile = (fileName.length() > 0 ? fileName : "output") + ".ckpt";
+  config.resumeFile = resumeFile;
+  if (rouletteDepth != -1) config.rouletteDepth = rouletteDepth;
+  if (nextEventEstimation != -1) config.nextEventEstimation = nextEventEstimation == 1;
+  config.toneMap = toneMap == -1 ? outputFormat == ImageFormat::PPM : toneMap == 1;
 
   if (integratorType == IntegratorType::Naive)
     config.integratorName = "Naive Path Tracer";
@@ -107,6 +237,8 @@ void ArgumentParser::setConfig(Config& config) {
     config.integratorName = "Bidirectional Path Tracer";
   else if (integratorType == IntegratorType::Metropolis)
     config.integratorName = "Metropolis Light Transport";
+  else if (integratorType == IntegratorType::Wavefront)
+    config.integratorName = "Wavefront Path Tracer";
 }
 
 void ArgumentParser::printInfo(const Config& config) {
@@ -117,6 +249,8 @@ void ArgumentParser::printInfo(const Config& config) {
       return "Bidirectional Path Tracer";
     else if (integratorType == IntegratorType::Metropolis)
       return "Metropolis Light Transport";
+    else if (integratorType == IntegratorType::Wavefront)
+      return "Wavefront Path Tracer";
     else
       return "Unknown";
   };
@@ -124,7 +258,32 @@ void ArgumentParser::printInfo(const Config& config) {
   std::cout << "\nINFO" << std::endl;
   std::cout << "Integrator:\t" << integratorName() << std::endl;
   std::cout << "Samples per pixel:\t" << config.samplesPerPixel << std::endl;
+  if (config.passCount > 1) std::cout << "Passes:\t\t\t" << config.passCount << std::endl;
+  if (config.checkpointInterval > 0)
+    std::cout << "Checkpoint:\t\t" << config.checkpointFile << " every " << config.checkpointInterval << "s"
+              << std::endl;
   std::cout << "Bounce limit:\t\t" << config.bounceLimit << std::endl;
+  std::cout << "Threads:\t\t" << config.threadCount << std::endl;
+  if (integratorType == IntegratorType::Metropolis) {
+    std::cout << "Chains:\t\t\t" << (config.chainCount > 0 ? config.chainCount : config.threadCount) << std::endl;
+    std::cout << "Bootstrap paths:\t" << config.bootstrapCount << std::endl;
+  }
+  if (integratorType == IntegratorType::Naive) {
+    std::cout << "Russian roulette:\t";
+    if (config.rouletteDepth > 0)
+      std::cout << "after " << config.rouletteDepth << " bounces" << std::endl;
+    else
+      std::cout << "off" << std::endl;
+    std::cout << "Light sampling:\t\t" << (config.nextEventEstimation ? "on" : "off") << std::endl;
+  }
+  const bool usesMIS = integratorType == IntegratorType::Bidirectional ||
+                       integratorType == IntegratorType::Metropolis ||
+                       (integratorType == IntegratorType::Naive && config.nextEventEstimation);
+  if (usesMIS) std::cout << "MIS:\t\t\t" << (config.misPower == 1 ? "balance" : "power") << " heuristic" << std::endl;
+  if (integratorType == IntegratorType::Naive || integratorType == IntegratorType::Wavefront)
+    std::cout << "Ray packets:\t\t" << (config.usePackets ? "on" : "off") << std::endl;
+  std::cout << "Output:\t\t\t" << Image::getExtension(config.outputFormat).substr(1)
+            << (config.toneMap ? ", tone mapped" : "") << std::endl;
   std::cout << "Dimension (h,w):\t" << config.imageHeight << "," << config.imageWidth << "\n\n";
 }
 
@@ -19,8 +19,20 @@ class AxisAlignedBoundingBox {
 
   Point3 getMin() const { return min; }
   Point3 getMax() const { return max; }
+  Point3 getCentroid() const { return 0.5 * min + 0.5 * max; }
 
-  inline bool intersect(const Ray& ray, double tMin, double tMax) const {
+  Real getSurfaceArea() const {
+    const Vector3 diagonal = max - min;
+    return 2 * (diagonal.x * diagonal.y + diagonal.x * diagonal.z + diagonal.y * diagonal.z);
+  }
+
+  // Returns the index of the axis with the largest extent.
+  int getLongestAxis() const {
+    Vector3 diagonal = max - min;
+    return diagonal.maxDimension();
+  }
+
+  inline bool intersect(const Ray& ray, Real tMin, Real tMax) const {
     for (int a = 0; a < 3; a++) {
       const auto inverseDirection = 1.0f / ray.direction[a];
       auto t0 = (min[a] - ray.origin[a]) * inverseDirection;
@@ -28,9 +28,9 @@ class BVHNode : public GeometricalObject {
 
  public:
   BVHNode() {}
-  BVHNode(Scene& scene, double time0, double time1) :
+  BVHNode(Scene& scene, Real time0, Real time1) :
       BVHNode(scene.getObjects(), 0, scene.getObjects().size(), time0, time1) {}
-  BVHNode(std::vector<std::shared_ptr<GeoObject>>& objects, size_t start, size_t end, double time0, double time1) {
+  BVHNode(std::vector<std::shared_ptr<GeoObject>>& objects, size_t start, size_t end, Real time0, Real time1) {
     int axis = Random::rangeInt(0, 2);
     auto comparator = (axis == 0) ? boxCompareX : (axis == 1) ? boxCompareY : boxCompareZ;
     const ushort objectSpan = end - start;
@@ -60,19 +60,29 @@ class BVHNode : public GeometricalObject {
     box = AABB::surroundingBox(boxLeft, boxRight);
   }
 
-  bool intersect(const Ray& ray, double tMin, double tMax, SInteraction& interaction) const override {
+  bool intersect(const Ray& ray, Real tMin, Real tMax, SInteraction& interaction) const override {
     if (!box.intersect(ray, tMin, tMax)) return false;
     const bool hitLeft = left->intersect(ray, tMin, tMax, interaction);
     const bool hitRight = right->intersect(ray, tMin, hitLeft ? interaction.t : tMax, interaction);
     return hitLeft || hitRight;
   }
 
-  bool computeBoundingBox(double t0, double t1, AABB& outputBox) const override {
+  bool occluded(const Ray& ray, Real tMin, Real tMax) const override {
+    if (!box.intersect(ray, tMin, tMax)) return false;
+    return left->occluded(ray, tMin, tMax) || right->occluded(ray, tMin, tMax);
+  }
+
+  bool computeBoundingBox(Real t0, Real t1, AABB& outputBox) const override {
     outputBox = box;
     return true;
   }
+
+  void collectMaterials(std::vector<std::shared_ptr<Material>>& materials) const override {
+    left->collectMaterials(materials);
+    if (right != left) right->collectMaterials(materials);
+  }
   
-	Point3 samplePoint() const override { return Point3(0, 0, 0); }
+	Point3 samplePoint(RNG& rng) const override { return Point3(0, 0, 0); }
 };
 
 #endif
\ No newline at end of file
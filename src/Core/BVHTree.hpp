@@ -0,0 +1,526 @@
+#ifndef BVH_TREE_HPP
+#define BVH_TREE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "../Math/Math.hpp"
+#include "../Math/Point3.hpp"
+#include "../Math/Ray.hpp"
+#include "../Math/RayPacket.hpp"
+#include "AxisAlignedBoundingBox.hpp"
+
+// Flattened BVH node, 32 bytes so two nodes share a cache line.
+// Nodes are stored in depth-first order: the first child of an interior node directly follows it and offset holds
+// the index of the second child. For leaves offset is the index of the first primitive.
+struct LinearBVHNode {
+  float boundsMin[3];
+  float boundsMax[3];
+  uint32_t offset;
+  uint16_t primitiveCount;  // 0 for interior nodes
+  uint8_t axis;             // split axis of interior nodes
+  uint8_t padding;
+
+  // Far plane distances are scaled by 1 + 2 gamma(3) (pbrt's robust bounds test), so that rounding in the slab test
+  // cannot cull a box the ray only touches, such as one cornered by the mesh vertex the ray passes through.
+  static constexpr Real machineEpsilon = std::numeric_limits<Real>::epsilon() / 2;
+  static constexpr Real farScale = 1 + 2 * (3 * machineEpsilon) / (1 - 3 * machineEpsilon);
+
+  bool isLeaf() const { return primitiveCount > 0; }
+
+  double getSurfaceArea() const {
+    const double dx = boundsMax[0] - boundsMin[0];
+    const double dy = boundsMax[1] - boundsMin[1];
+    const double dz = boundsMax[2] - boundsMin[2];
+    return 2 * (dx * dy + dx * dz + dy * dz);
+  }
+
+  // Slab test. dirIsNeg selects the near plane per axis, so no swap is needed.
+  inline bool intersect(const Real origin[3], const Real inverseDirection[3], const int dirIsNeg[3], Real tMin,
+                        Real tMax) const {
+    for (int a = 0; a < 3; a++) {
+      const Real tNear = ((dirIsNeg[a] ? boundsMax[a] : boundsMin[a]) - origin[a]) * inverseDirection[a];
+      const Real tFar = ((dirIsNeg[a] ? boundsMin[a] : boundsMax[a]) - origin[a]) * inverseDirection[a] * farScale;
+      tMin = tNear > tMin ? tNear : tMin;
+      tMax = tFar < tMax ? tFar : tMax;
+      if (tMin > tMax) return false;
+    }
+    return true;
+  }
+
+  // Slab test of all packet lanes at once, returning the mask of lanes that hit. Lanes are tested with the same
+  // operations as the scalar test, so both agree exactly. With SSE2 a float build tests all four lanes in one register
+  // and a double build two lanes per register.
+  inline int intersect(const RayPacket& packet, const Real tMin[RayPacket::size],
+                       const Real tMax[RayPacket::size]) const {
+#if defined(__SSE2__) && defined(RAY_TRACING_FLOAT)
+    __m128 laneMin = _mm_loadu_ps(tMin);
+    __m128 laneMax = _mm_loadu_ps(tMax);
+    for (int a = 0; a < 3; a++) {
+      const __m128 origin = _mm_load_ps(packet.origin[a]);
+      const __m128 inverseDirection = _mm_load_ps(packet.inverseDirection[a]);
+      const __m128 isNegative = _mm_castsi128_ps(_mm_load_si128((const __m128i*)packet.negativeMask[a]));
+      const __m128 t0 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(boundsMin[a]), origin), inverseDirection);
+      const __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(boundsMax[a]), origin), inverseDirection);
+      const __m128 tNear = _mm_or_ps(_mm_and_ps(isNegative, t1), _mm_andnot_ps(isNegative, t0));
+      const __m128 tFar =
+          _mm_mul_ps(_mm_or_ps(_mm_and_ps(isNegative, t0), _mm_andnot_ps(isNegative, t1)), _mm_set1_ps(farScale));
+      laneMin = _mm_max_ps(tNear, laneMin);
+      laneMax = _mm_min_ps(tFar, laneMax);
+    }
+    return _mm_movemask_ps(_mm_cmpngt_ps(laneMin, laneMax)) & packet.activeMask;
+#elif defined(__SSE2__)
+    int mask = 0;
+    for (int lane = 0; lane < RayPacket::size; lane += 2) {
+      __m128d laneMin = _mm_loadu_pd(tMin + lane);
+      __m128d laneMax = _mm_loadu_pd(tMax + lane);
+      for (int a = 0; a < 3; a++) {
+        const __m128d origin = _mm_load_pd(&packet.origin[a][lane]);
+        const __m128d inverseDirection = _mm_load_pd(&packet.inverseDirection[a][lane]);
+        const __m128d isNegative = _mm_castsi128_pd(_mm_load_si128((const __m128i*)&packet.negativeMask[a][lane]));
+        const __m128d t0 = _mm_mul_pd(_mm_sub_pd(_mm_set1_pd(boundsMin[a]), origin), inverseDirection);
+        const __m128d t1 = _mm_mul_pd(_mm_sub_pd(_mm_set1_pd(boundsMax[a]), origin), inverseDirection);
+        const __m128d tNear = _mm_or_pd(_mm_and_pd(isNegative, t1), _mm_andnot_pd(isNegative, t0));
+        const __m128d tFar =
+            _mm_mul_pd(_mm_or_pd(_mm_and_pd(isNegative, t0), _mm_andnot_pd(isNegative, t1)), _mm_set1_pd(farScale));
+        laneMin = _mm_max_pd(tNear, laneMin);
+        laneMax = _mm_min_pd(tFar, laneMax);
+      }
+      mask |= _mm_movemask_pd(_mm_cmpngt_pd(laneMin, laneMax)) << lane;
+    }
+    return mask & packet.activeMask;
+#else
+    int mask = 0;
+    for (int lane = 0; lane < RayPacket::size; lane++) {
+      if (!RayPacket::isSet(packet.activeMask, lane)) continue;
+      const Real origin[3] = {packet.origin[0][lane], packet.origin[1][lane], packet.origin[2][lane]};
+      const Real inverseDirection[3] = {packet.inverseDirection[0][lane], packet.inverseDirection[1][lane],
+                                        packet.inverseDirection[2][lane]};
+      const int dirIsNeg[3] = {inverseDirection[0] < 0, inverseDirection[1] < 0, inverseDirection[2] < 0};
+      if (intersect(origin, inverseDirection, dirIsNeg, tMin[lane], tMax[lane])) mask |= 1 << lane;
+    }
+    return mask;
+#endif
+  }
+};
+
+static_assert(sizeof(LinearBVHNode) == 32, "LinearBVHNode must stay 32 bytes");
+
+enum class BVHSplitMethod { Median, SAH };
+
+struct BVHBuildOptions {
+  BVHSplitMethod splitMethod = BVHSplitMethod::SAH;
+  size_t binCount = 12;
+  size_t maxPrimitivesInLeaf = 4;
+
+  // Relative costs of visiting a node and intersecting a primitive, used by the SAH.
+  double traversalCost = 1.0;
+  double intersectionCost = 1.0;
+};
+
+// Quality figures of a built tree. sahCost is the expected cost of a random ray hitting the root box.
+struct BVHStats {
+  size_t nodeCount = 0;
+  size_t leafCount = 0;
+  size_t maxDepth = 0;
+  size_t maxPrimitivesInLeaf = 0;
+  double averageLeafDepth = 0;
+  double averagePrimitivesInLeaf = 0;
+  double sahCost = 0;
+
+  friend std::ostream& operator<<(std::ostream& out, const BVHStats& stats) {
+    return out << "nodes " << stats.nodeCount << ", leaves " << stats.leafCount << ", SAH cost " << stats.sahCost
+               << ", max depth " << stats.maxDepth << ", avg leaf depth " << stats.averageLeafDepth
+               << ", prims/leaf avg " << stats.averagePrimitivesInLeaf << " max " << stats.maxPrimitivesInLeaf;
+  }
+};
+
+// Primitive agnostic bounding volume hierarchy over a set of boxes.
+// It only stores nodes; callers reorder their primitives with getPrimitiveOrder() once after build() so that leaf
+// ranges index straight into their own arrays.
+class BVHTree {
+ private:
+  struct BuildPrimitive {
+    AABB box;
+    Point3 centroid;
+    uint32_t index;
+  };
+
+  static constexpr int maxDepth = 64;
+
+  // Primitive counts and bounds of one SAH bin.
+  struct Bin {
+    size_t count = 0;
+    AABB box;
+  };
+
+  std::vector<LinearBVHNode> nodes;
+  std::vector<uint32_t> primitiveOrder;
+  BVHBuildOptions options;
+
+  // Rounds outwards so the float box always contains the double one.
+  static float roundDown(double value) {
+    float result = static_cast<float>(value);
+    if (result > value) result = std::nextafter(result, -std::numeric_limits<float>::infinity());
+    return result;
+  }
+  static float roundUp(double value) {
+    float result = static_cast<float>(value);
+    if (result < value) result = std::nextafter(result, std::numeric_limits<float>::infinity());
+    return result;
+  }
+
+  void setBounds(LinearBVHNode& node, const AABB& box) {
+    for (int a = 0; a < 3; a++) {
+      node.boundsMin[a] = roundDown(box.getMin()[a]);
+      node.boundsMax[a] = roundUp(box.getMax()[a]);
+    }
+  }
+
+  void makeLeaf(LinearBVHNode& node, std::vector<BuildPrimitive>& primitives, size_t start, size_t end) {
+    node.offset = primitiveOrder.size();
+    node.primitiveCount = end - start;
+    for (size_t i = start; i < end; i++) primitiveOrder.push_back(primitives[i].index);
+  }
+
+  void splitMedian(std::vector<BuildPrimitive>& primitives, size_t start, size_t end, int axis, size_t& mid) {
+    mid = start + (end - start) / 2;
+    std::nth_element(primitives.begin() + start, primitives.begin() + mid, primitives.begin() + end,
+                     [axis](const BuildPrimitive& a, const BuildPrimitive& b) {
+                       return a.centroid[axis] < b.centroid[axis];
+                     });
+  }
+
+  // Binned SAH (Wald, "On fast Construction of SAH-based Bounding Volume Hierarchies"). Bins the centroids along the
+  // longest axis and partitions at the cheapest bin boundary. Returns false if the node fits in a leaf and a leaf is
+  // cheaper than any split.
+  bool splitSAH(std::vector<BuildPrimitive>& primitives, size_t start, size_t end, const AABB& box,
+                const AABB& centroidBox, int axis, size_t& mid) {
+    const size_t binCount = options.binCount;
+    const double centroidMin = centroidBox.getMin()[axis];
+    const double binScale = binCount / (centroidBox.getMax()[axis] - centroidMin);
+    auto binIndex = [&](const BuildPrimitive& primitive) {
+      const size_t index = (primitive.centroid[axis] - centroidMin) * binScale;
+      return std::min(index, binCount - 1);
+    };
+
+    std::vector<Bin> bins(binCount);
+    for (size_t i = start; i < end; i++) {
+      Bin& bin = bins[binIndex(primitives[i])];
+      bin.box = bin.count == 0 ? primitives[i].box : AABB::surroundingBox(bin.box, primitives[i].box);
+      bin.count++;
+    }
+
+    // Sweep from the right to collect the area and count above every boundary, then from the left to evaluate.
+    std::vector<double> areaAbove(binCount, 0.0);
+    std::vector<size_t> countAbove(binCount, 0);
+    AABB sweepBox;
+    size_t sweepCount = 0;
+    for (size_t i = binCount - 1; i > 0; i--) {
+      if (bins[i].count > 0) {
+        sweepBox = sweepCount == 0 ? bins[i].box : AABB::surroundingBox(sweepBox, bins[i].box);
+        sweepCount += bins[i].count;
+      }
+      areaAbove[i - 1] = sweepCount > 0 ? sweepBox.getSurfaceArea() : 0.0;
+      countAbove[i - 1] = sweepCount;
+    }
+
+    double minCost = Math::infinity;
+    size_t minBoundary = 0;
+    sweepCount = 0;
+    for (size_t i = 0; i < binCount - 1; i++) {
+      if (bins[i].count > 0) {
+        sweepBox = sweepCount == 0 ? bins[i].box : AABB::surroundingBox(sweepBox, bins[i].box);
+        sweepCount += bins[i].count;
+      }
+      if (sweepCount == 0 || countAbove[i] == 0) continue;
+      const double cost = sweepCount * sweepBox.getSurfaceArea() + countAbove[i] * areaAbove[i];
+      if (cost < minCost) {
+        minCost = cost;
+        minBoundary = i;
+      }
+    }
+
+    const size_t count = end - start;
+    const double splitCost = options.traversalCost + options.intersectionCost * minCost / box.getSurfaceArea();
+    const double leafCost = options.intersectionCost * count;
+    if (minCost == Math::infinity || (splitCost >= leafCost && count <= options.maxPrimitivesInLeaf)) return false;
+
+    auto middle = std::partition(primitives.begin() + start, primitives.begin() + end,
+                                 [&](const BuildPrimitive& primitive) { return binIndex(primitive) <= minBoundary; });
+    mid = middle - primitives.begin();
+    return true;
+  }
+
+  void buildRecursive(std::vector<BuildPrimitive>& primitives, size_t start, size_t end, int depth) {
+    const size_t nodeIndex = nodes.size();
+    nodes.emplace_back();
+
+    AABB box = primitives[start].box;
+    AABB centroidBox(primitives[start].centroid, primitives[start].centroid);
+    for (size_t i = start + 1; i < end; i++) {
+      box = AABB::surroundingBox(box, primitives[i].box);
+      centroidBox = AABB::surroundingBox(centroidBox, AABB(primitives[i].centroid, primitives[i].centroid));
+    }
+    setBounds(nodes[nodeIndex], box);
+
+    const size_t count = end - start;
+    const int axis = centroidBox.getLongestAxis();
+    const bool isDegenerate = centroidBox.getMax()[axis] == centroidBox.getMin()[axis];
+    const bool fitsLeaf = count <= std::numeric_limits<uint16_t>::max();
+    const bool useSAH = options.splitMethod == BVHSplitMethod::SAH;
+
+    // The SAH decides on its own whether small nodes are worth splitting.
+    const size_t leafSize = useSAH ? 1 : options.maxPrimitivesInLeaf;
+    if (count <= leafSize || depth >= maxDepth - 1 || (isDegenerate && fitsLeaf)) {
+      makeLeaf(nodes[nodeIndex], primitives, start, end);
+      return;
+    }
+
+    size_t mid = start + count / 2;
+    if (useSAH && !isDegenerate) {
+      if (!splitSAH(primitives, start, end, box, centroidBox, axis, mid) && fitsLeaf) {
+        makeLeaf(nodes[nodeIndex], primitives, start, end);
+        return;
+      }
+    } else {
+      splitMedian(primitives, start, end, axis, mid);
+    }
+
+    buildRecursive(primitives, start, mid, depth + 1);
+    const size_t secondChild = nodes.size();
+    buildRecursive(primitives, mid, end, depth + 1);
+
+    nodes[nodeIndex].offset = secondChild;
+    nodes[nodeIndex].primitiveCount = 0;
+    nodes[nodeIndex].axis = axis;
+  }
+
+ public:
+  BVHTree() {}
+
+  void build(const std::vector<AABB>& boxes, const BVHBuildOptions& options = BVHBuildOptions()) {
+    this->options = options;
+    this->options.maxPrimitivesInLeaf = std::max<size_t>(options.maxPrimitivesInLeaf, 1);
+    this->options.binCount = std::max<size_t>(options.binCount, 2);
+    nodes.clear();
+    primitiveOrder.clear();
+    if (boxes.empty()) return;
+
+    std::vector<BuildPrimitive> primitives(boxes.size());
+    for (size_t i = 0; i < boxes.size(); i++) {
+      primitives[i].box = boxes[i];
+      primitives[i].centroid = boxes[i].getCentroid();
+      primitives[i].index = i;
+    }
+
+    nodes.reserve(2 * boxes.size());
+    primitiveOrder.reserve(boxes.size());
+    buildRecursive(primitives, 0, primitives.size(), 0);
+    nodes.shrink_to_fit();
+  }
+
+  bool empty() const { return nodes.empty(); }
+  size_t getNodeCount() const { return nodes.size(); }
+  const std::vector<uint32_t>& getPrimitiveOrder() const { return primitiveOrder; }
+
+  BVHStats computeStats() const {
+    BVHStats stats;
+    if (nodes.empty()) return stats;
+
+    const double rootArea = nodes.front().getSurfaceArea();
+    size_t primitiveCount = 0;
+    size_t leafDepthSum = 0;
+
+    std::vector<std::pair<uint32_t, size_t>> stack = {{0, 0}};
+    while (!stack.empty()) {
+      const auto [index, depth] = stack.back();
+      stack.pop_back();
+      const LinearBVHNode& node = nodes[index];
+      const double relativeArea = rootArea > 0 ? node.getSurfaceArea() / rootArea : 1.0;
+
+      stats.nodeCount++;
+      stats.maxDepth = std::max(stats.maxDepth, depth);
+      if (node.isLeaf()) {
+        stats.leafCount++;
+        stats.maxPrimitivesInLeaf = std::max<size_t>(stats.maxPrimitivesInLeaf, node.primitiveCount);
+        stats.sahCost += relativeArea * options.intersectionCost * node.primitiveCount;
+        primitiveCount += node.primitiveCount;
+        leafDepthSum += depth;
+      } else {
+        stats.sahCost += relativeArea * options.traversalCost;
+        stack.push_back({index + 1, depth + 1});
+        stack.push_back({node.offset, depth + 1});
+      }
+    }
+    stats.averageLeafDepth = double(leafDepthSum) / stats.leafCount;
+    stats.averagePrimitivesInLeaf = double(primitiveCount) / stats.leafCount;
+    return stats;
+  }
+
+  AABB getBounds() const {
+    const LinearBVHNode& root = nodes.front();
+    return AABB(Point3(root.boundsMin[0], root.boundsMin[1], root.boundsMin[2]),
+                Point3(root.boundsMax[0], root.boundsMax[1], root.boundsMax[2]));
+  }
+
+  // Closest hit traversal. leafFunction(primitiveIndex, tMax) tests one primitive and returns true on a hit, in which
+  // case it also shrinks tMax to the hit distance. Children are visited near first along the split axis.
+  template <typename LeafFunction>
+  bool intersect(const Ray& ray, Real tMin, Real tMax, LeafFunction leafFunction) const {
+    if (nodes.empty()) return false;
+
+    const Real origin[3] = {ray.origin.x, ray.origin.y, ray.origin.z};
+    const Real inverseDirection[3] = {1 / ray.direction.x, 1 / ray.direction.y, 1 / ray.direction.z};
+    const int dirIsNeg[3] = {inverseDirection[0] < 0, inverseDirection[1] < 0, inverseDirection[2] < 0};
+
+    uint32_t stack[maxDepth];
+    int stackSize = 0;
+    uint32_t current = 0;
+    bool hitAnything = false;
+
+    while (true) {
+      const LinearBVHNode& node = nodes[current];
+      if (node.intersect(origin, inverseDirection, dirIsNeg, tMin, tMax)) {
+        if (node.isLeaf()) {
+          for (uint32_t i = 0; i < node.primitiveCount; i++)
+            if (leafFunction(node.offset + i, tMax)) hitAnything = true;
+          if (stackSize == 0) break;
+          current = stack[--stackSize];
+        } else if (dirIsNeg[node.axis]) {
+          stack[stackSize++] = current + 1;
+          current = node.offset;
+        } else {
+          stack[stackSize++] = node.offset;
+          current = current + 1;
+        }
+      } else {
+        if (stackSize == 0) break;
+        current = stack[--stackSize];
+      }
+    }
+    return hitAnything;
+  }
+
+  // Any hit traversal. leafFunction(primitiveIndex) returns true if the primitive blocks the ray, which ends the query.
+  template <typename LeafFunction>
+  bool occluded(const Ray& ray, Real tMin, Real tMax, LeafFunction leafFunction) const {
+    if (nodes.empty()) return false;
+
+    const Real origin[3] = {ray.origin.x, ray.origin.y, ray.origin.z};
+    const Real inverseDirection[3] = {1 / ray.direction.x, 1 / ray.direction.y, 1 / ray.direction.z};
+    const int dirIsNeg[3] = {inverseDirection[0] < 0, inverseDirection[1] < 0, inverseDirection[2] < 0};
+
+    uint32_t stack[maxDepth];
+    int stackSize = 0;
+    uint32_t current = 0;
+
+    while (true) {
+      const LinearBVHNode& node = nodes[current];
+      if (node.intersect(origin, inverseDirection, dirIsNeg, tMin, tMax)) {
+        if (node.isLeaf()) {
+          for (uint32_t i = 0; i < node.primitiveCount; i++)
+            if (leafFunction(node.offset + i)) return true;
+          if (stackSize == 0) break;
+          current = stack[--stackSize];
+        } else {
+          stack[stackSize++] = node.offset;
+          current = current + 1;
+        }
+      } else {
+        if (stackSize == 0) break;
+        current = stack[--stackSize];
+      }
+    }
+    return false;
+  }
+
+  // Closest hit traversal of the packet lanes in laneMask. A node is entered if any of them hits it and its primitives
+  // are tested only for those lanes. leafFunction(primitiveIndex, laneMask, tMax) shrinks the lanes of tMax it hits and
+  // returns their mask. Children are ordered by the first lane's direction, which suits coherent packets.
+  template <typename LeafFunction>
+  int intersect(const RayPacket& packet, int laneMask, Real tMin, Real tMax[RayPacket::size],
+                LeafFunction leafFunction) const {
+    laneMask &= packet.activeMask;
+    if (nodes.empty() || laneMask == 0) return 0;
+
+    Real tMinLanes[RayPacket::size];
+    for (int lane = 0; lane < RayPacket::size; lane++) tMinLanes[lane] = tMin;
+    int leadLane = 0;
+    while (!RayPacket::isSet(laneMask, leadLane)) leadLane++;
+
+    uint32_t stack[maxDepth];
+    int stackSize = 0;
+    uint32_t current = 0;
+    int hitMask = 0;
+
+    while (true) {
+      const LinearBVHNode& node = nodes[current];
+      const int nodeMask = node.intersect(packet, tMinLanes, tMax) & laneMask;
+      if (nodeMask != 0) {
+        if (node.isLeaf()) {
+          for (uint32_t i = 0; i < node.primitiveCount; i++) hitMask |= leafFunction(node.offset + i, nodeMask, tMax);
+          if (stackSize == 0) break;
+          current = stack[--stackSize];
+        } else if (packet.negativeMask[node.axis][leadLane]) {
+          stack[stackSize++] = current + 1;
+          current = node.offset;
+        } else {
+          stack[stackSize++] = node.offset;
+          current = current + 1;
+        }
+      } else {
+        if (stackSize == 0) break;
+        current = stack[--stackSize];
+      }
+    }
+    return hitMask;
+  }
+
+  // Any hit traversal of the packet lanes in laneMask. leafFunction(primitiveIndex, laneMask) returns the lanes the
+  // primitive blocks; those drop out and the query ends once every lane is blocked. Returns the blocked lanes.
+  template <typename LeafFunction>
+  int occluded(const RayPacket& packet, int laneMask, Real tMin, const Real tMax[RayPacket::size],
+               LeafFunction leafFunction) const {
+    laneMask &= packet.activeMask;
+    if (nodes.empty() || laneMask == 0) return 0;
+
+    Real tMinLanes[RayPacket::size];
+    for (int lane = 0; lane < RayPacket::size; lane++) tMinLanes[lane] = tMin;
+
+    uint32_t stack[maxDepth];
+    int stackSize = 0;
+    uint32_t current = 0;
+    int blockedMask = 0;
+
+    while (true) {
+      const LinearBVHNode& node = nodes[current];
+      const int nodeMask = node.intersect(packet, tMinLanes, tMax) & laneMask & ~blockedMask;
+      if (nodeMask != 0) {
+        if (node.isLeaf()) {
+          for (uint32_t i = 0; i < node.primitiveCount && (nodeMask & ~blockedMask); i++)
+            blockedMask |= leafFunction(node.offset + i, nodeMask & ~blockedMask);
+          if (blockedMask == laneMask || stackSize == 0) break;
+          current = stack[--stackSize];
+        } else {
+          stack[stackSize++] = node.offset;
+          current = current + 1;
+        }
+      } else {
+        if (stackSize == 0) break;
+        current = stack[--stackSize];
+      }
+    }
+    return blockedMask;
+  }
+};
+
+#endif
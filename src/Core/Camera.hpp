@@ -28,7 +28,6 @@ class Camera {
     viewportHeight = 2.0 * std::tan(Math::degreesToRadians(vertFov) / 2.0);
 
     const auto viewportWidth = viewportHeight * aspectRatio;
-    const auto focalLength = 1.0;
 
     w = (lookFrom - lookAt).normalized();
     u = cross(viewUp, w).normalized();
@@ -48,16 +47,16 @@ class Camera {
       Camera(config.lookFrom, config.lookAt, config.viewUp, config.verticalFOV, config.aspectRatio, config.aperture,
              config.focusDist, time0, time1) {}
 
-  Ray getRay(Point2 sample) const {
-    const Vector3 random = lensRadius * Random::vectorInUnitDisk();
+  Ray getRay(Point2 sample, RNG& rng) const {
+    const Vector3 random = lensRadius * Random::vectorInUnitDisk(rng);
     const Vector3 offset = u * random.x + v * random.y;
     const Vector3 direction = lowerLeftCorner + sample.x * horizontal + sample.y * vertical - origin - offset;
-    return Ray(origin + offset, direction, Random::range(time0, time1));
+    return Ray(origin + offset, direction, Random::range(rng, time0, time1));
   }
 
-  Ray getSample(ushort imageHeight, ushort imageWidth) const {
-    const Vector3 su = u * -(0.5 - Random::fraction()) * imageWidth;
-    const Vector3 sv = v * (0.5 - Random::fraction()) * imageHeight;
+  Ray getSample(ushort imageHeight, ushort imageWidth, RNG& rng) const {
+    const Vector3 su = u * -(0.5 - Random::fraction(rng)) * imageWidth;
+    const Vector3 sv = v * (0.5 - Random::fraction(rng)) * imageHeight;
     const Vector3 sw = -w * getDist(imageHeight);
     return Ray(origin, (su + sv + sw).normalized());
   }
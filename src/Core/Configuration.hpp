@@ -1,8 +1,12 @@
 #ifndef CONFIGURATION_HPP
 #define CONFIGURATION_HPP
 
+#include <string>
+#include <thread>
+
 #include "../Math/Point3.hpp"
 #include "../Math/Vector3.hpp"
+#include "Image.hpp"
 
 struct Configuration {
 	// Camera Position
@@ -20,11 +24,27 @@ struct Configuration {
   size_t imageWidth = 400;
   size_t imageHeight = static_cast<size_t>(imageWidth / aspectRatio);
   Color background = Color(0, 0, 0);
+  ImageFormat outputFormat = ImageFormat::PPM;
+  bool toneMap = true;  // applied before writing; the HDR formats default to raw radiance
 
 	// Renderer
 	std::string integratorName;
   int samplesPerPixel = 1;
   int bounceLimit = 8;
+  unsigned threadCount = std::thread::hardware_concurrency();
+  int passCount = 1;              // progressive passes of samplesPerPixel samples each
+  unsigned chainCount = 0;        // independent MLT chains, 0 runs one per thread
+  unsigned bootstrapCount = 10000;  // MLT paths estimating the normalization constant and seeding the chains
+  int checkpointInterval = 0;     // seconds between checkpoints, 0 disables them
+  std::string checkpointFile = "output.ckpt";
+  std::string resumeFile;
+  double misPower = 1;      // BDPT and MLT strategy weights: 1 balance heuristic, 2 power heuristic
+  bool usePackets = false;  // trace camera rays in packets of four (naive integrator)
+  int rouletteDepth = 3;    // naive integrator: bounces before Russian roulette may end a path, 0 disables it
+  bool nextEventEstimation = true;  // naive integrator: sample the lights at diffuse hits
+
+  // Scene
+  std::string meshFile;  // OBJ or binary PLY file shown in scene 10
 };
 
 using Config = Configuration;
@@ -1,13 +1,22 @@
 #ifndef IMAGE_HPP
 #define IMAGE_HPP
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <iostream>
+#include <sstream>
+#include <string>
 #include <vector>
 
 #include "../Math/Math.hpp"
 #include "../Math/Vector3.hpp"
 
+// PPM is binary P6 and needs tone mapping; PFM (32-bit float) and HDR (Radiance RGBE) keep the radiance as is.
+enum class ImageFormat { PPM, PFM, HDR };
+
 struct ImageInfo {
   size_t height;
   size_t width;
@@ -26,12 +35,18 @@ struct ImageInfo {
   }
 };
 
+// Pixels are stored top row first. Integrators accumulate sample sums; normalize() turns them into radiance and
+// toneMap() optionally compresses that into [0, 1) before writing.
 class Image {
  private:
   std::vector<Color> pixels;
   size_t height;
   size_t width;
 
+  std::string encodePPM() const;
+  std::string encodePFM() const;
+  std::string encodeHDR() const;
+
  public:
   ImageInfo imageInfo;
   Image() = delete;
@@ -41,8 +56,18 @@ class Image {
     imageInfo.width = width;
   }
 
-  void writeToFile(std::string fileName, int samplesPerPixel);
-  int toInt(double x) { return int(std::pow(1 - std::exp(-x), 1 / 2.2) * 255 + .5); }
+  void normalize(int samplesPerPixel);
+  void toneMap();
+  void writeToFile(std::string fileName, ImageFormat format = ImageFormat::PPM) const;
+
+  static std::string getExtension(ImageFormat format);
+  // Display encoding of the PPM writer: clamp to [0, 1], gamma 2.2, 8 bits.
+  static uint8_t toByte(double x) { return uint8_t(std::pow(Math::clamp(x, 0.0, 1.0), 1 / 2.2) * 255 + .5); }
+
+  Image& operator+=(const Image& other) {
+    for (size_t i = 0; i < pixels.size(); i++) pixels[i] += other.pixels[i];
+    return *this;
+  }
 
   Color& operator[](int index) { return pixels[index]; }
   Color operator[](int index) const { return pixels[index]; }
@@ -51,31 +76,106 @@ class Image {
   size_t getWidth() const { return width; }
 };
 
-void Image::writeToFile(std::string fileName, int samplesPerPixel) {
-  if (fileName.length() > 0)
-    fileName = fileName + ".ppm";
-  else
-    fileName = "output.ppm";
-
-  std::ofstream outputFile(fileName);
-  outputFile << "P3" << std::endl;
-  outputFile << imageInfo << std::endl;
-  outputFile << width << "	" << height << std::endl;
-  outputFile << "255" << std::endl;
-
-  for (int j = 0; j < height; ++j) {
-    for (int i = 0; i < width; ++i) {
-      Color color = pixels[j * width + i];
-      //	Divide the color total by the number of samples.
-      //	Gamma-correct for gamma=2.0.
-      // const auto scale = 1.0 / samplesPerPixel;
-      const auto scale = 1.0 / double(samplesPerPixel);
-      // Color printColor(std::sqrt(color.red * scale), std::sqrt(color.green * scale), std::sqrt(color.blue * scale));
-      outputFile << static_cast<int>(toInt(color.red * scale)) << "	"
-                 << static_cast<int>(toInt(color.green * scale)) << "	" << static_cast<int>(toInt(color.blue * scale))
-                 << std::endl;
+void Image::normalize(int samplesPerPixel) {
+  const auto scale = 1.0 / double(samplesPerPixel);
+  for (auto& pixel : pixels) pixel *= scale;
+}
+
+// Exponential tone mapping, 1 - exp(-x) per channel.
+void Image::toneMap() {
+  for (auto& pixel : pixels)
+    pixel = Color(1 - std::exp(-pixel.red), 1 - std::exp(-pixel.green), 1 - std::exp(-pixel.blue));
+}
+
+std::string Image::getExtension(ImageFormat format) {
+  switch (format) {
+    case ImageFormat::PFM:
+      return ".pfm";
+    case ImageFormat::HDR:
+      return ".hdr";
+    default:
+      return ".ppm";
+  }
+}
+
+std::string Image::encodePPM() const {
+  std::ostringstream header;
+  header << "P6" << std::endl << imageInfo << width << " " << height << std::endl << "255" << std::endl;
+
+  std::string buffer = header.str();
+  const size_t offset = buffer.size();
+  buffer.resize(offset + 3 * pixels.size());
+  for (size_t i = 0; i < pixels.size(); i++) {
+    buffer[offset + 3 * i] = toByte(pixels[i].red);
+    buffer[offset + 3 * i + 1] = toByte(pixels[i].green);
+    buffer[offset + 3 * i + 2] = toByte(pixels[i].blue);
+  }
+  return buffer;
+}
+
+// Rows go bottom to top; a negative scale marks little endian data.
+std::string Image::encodePFM() const {
+  const uint16_t endianTest = 1;
+  const bool isLittleEndian = *reinterpret_cast<const uint8_t*>(&endianTest) == 1;
+
+  std::ostringstream header;
+  header << "PF\n" << width << " " << height << "\n" << (isLittleEndian ? "-1.0" : "1.0") << "\n";
+
+  std::string buffer = header.str();
+  const size_t offset = buffer.size();
+  buffer.resize(offset + 3 * sizeof(float) * pixels.size());
+  char* data = &buffer[offset];
+  for (size_t j = 0; j < height; j++) {
+    for (size_t i = 0; i < width; i++) {
+      const Color& pixel = pixels[(height - 1 - j) * width + i];
+      const float rgb[3] = {float(pixel.red), float(pixel.green), float(pixel.blue)};
+      std::memcpy(data, rgb, sizeof(rgb));
+      data += sizeof(rgb);
+    }
+  }
+  return buffer;
+}
+
+// Radiance RGBE with flat (uncompressed) scanlines, top row first.
+std::string Image::encodeHDR() const {
+  std::ostringstream header;
+  header << "#?RADIANCE\nFORMAT=32-bit_rle_rgbe\n\n-Y " << height << " +X " << width << "\n";
+
+  std::string buffer = header.str();
+  const size_t offset = buffer.size();
+  buffer.resize(offset + 4 * pixels.size());
+  for (size_t i = 0; i < pixels.size(); i++) {
+    const Color& pixel = pixels[i];
+    const double maxComponent = std::max(pixel.maxComponent(), 0.0);
+    uint8_t rgbe[4] = {0, 0, 0, 0};
+    if (maxComponent >= 1e-32) {
+      int exponent;
+      const double scale = std::frexp(maxComponent, &exponent) * 256.0 / maxComponent;
+      rgbe[0] = uint8_t(std::max(pixel.red, 0.0) * scale);
+      rgbe[1] = uint8_t(std::max(pixel.green, 0.0) * scale);
+      rgbe[2] = uint8_t(std::max(pixel.blue, 0.0) * scale);
+      rgbe[3] = uint8_t(exponent + 128);
     }
+    std::memcpy(&buffer[offset + 4 * i], rgbe, sizeof(rgbe));
   }
+  return buffer;
+}
+
+// Encodes the whole file in memory and writes it in one call.
+void Image::writeToFile(std::string fileName, ImageFormat format) const {
+  fileName = (fileName.length() > 0 ? fileName : "output") + getExtension(format);
+
+  std::string buffer;
+  if (format == ImageFormat::PFM)
+    buffer = encodePFM();
+  else if (format == ImageFormat::HDR)
+    buffer = encodeHDR();
+  else
+    buffer = encodePPM();
+
+  std::ofstream outputFile(fileName, std::ios::binary);
+  outputFile.write(buffer.data(), buffer.size());
+  if (!outputFile) std::cerr << "ERROR: Could not write image file '" << fileName << "'." << std::endl;
 }
 
-#endif
\ No newline at end of file
+#endif
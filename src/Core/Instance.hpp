@@ -0,0 +1,94 @@
+#ifndef INSTANCE_HPP
+#define INSTANCE_HPP
+
+#include <cmath>
+#include <memory>
+
+#include "../GeoObjects/GeometricalObject.hpp"
+#include "../Math/Transform.hpp"
+
+// A copy of an object placed in the world by an affine transform. The object, usually a LinearBVH over an asset, is
+// shared by all its instances and never copied, so a scene of many copies costs one asset plus an instance each.
+// Instances added to a Scene (or gathered in a LinearBVH) form the top level hierarchy over their world boxes; the
+// shared object is the bottom level, traversed with the ray taken into its frame. Replaces a chain of RotateY and
+// Translate wrappers with one hop.
+class Instance : public GeometricalObject {
+ private:
+  std::shared_ptr<const GeometricalObject> object;
+  Transform objectToWorld;
+  bool hasBox;
+  AABB boundingBox;
+
+  // Takes a hit in the object's frame to the world. The hit distance is the same along both rays, and frontFace
+  // already tells on which side of the surface the ray arrived.
+  void toWorld(SInteraction& interaction) const {
+    interaction.point = objectToWorld.applyToPoint(interaction.point);
+    interaction.normal = objectToWorld.applyToNormal(interaction.normal).normalized();
+  }
+
+  RayPacket toObject(const RayPacket& packet, int laneMask) const {
+    RayPacket objectPacket;
+    for (int lane = 0; lane < RayPacket::size; lane++)
+      if (RayPacket::isSet(laneMask, lane)) objectPacket.set(lane, objectToWorld.applyInverse(packet.rays[lane]));
+    return objectPacket;
+  }
+
+ public:
+  Instance(std::shared_ptr<const GeoObject> object, const Transform& objectToWorld) :
+      object(object),
+      objectToWorld(objectToWorld) {
+    AABB objectBox;
+    hasBox = object->computeBoundingBox(0, 1, objectBox);
+    if (!hasBox) return;
+
+    // World box around the eight transformed corners.
+    Point3 min(Math::realInfinity, Math::realInfinity, Math::realInfinity);
+    Point3 max(-Math::realInfinity, -Math::realInfinity, -Math::realInfinity);
+    for (int corner = 0; corner < 8; corner++) {
+      const Point3 point(corner & 1 ? objectBox.getMax().x : objectBox.getMin().x,
+                         corner & 2 ? objectBox.getMax().y : objectBox.getMin().y,
+                         corner & 4 ? objectBox.getMax().z : objectBox.getMin().z);
+      const Point3 worldPoint = objectToWorld.applyToPoint(point);
+      for (int c = 0; c < 3; c++) {
+        min[c] = std::fmin(min[c], worldPoint[c]);
+        max[c] = std::fmax(max[c], worldPoint[c]);
+      }
+    }
+    boundingBox = AABB(min, max);
+  }
+
+  const Transform& getTransform() const { return objectToWorld; }
+
+  virtual bool intersect(const Ray& ray, Real tMin, Real tMax, SInteraction& interaction) const override {
+    if (!object->intersect(objectToWorld.applyInverse(ray), tMin, tMax, interaction)) return false;
+    toWorld(interaction);
+    return true;
+  }
+
+  virtual bool occluded(const Ray& ray, Real tMin, Real tMax) const override {
+    return object->occluded(objectToWorld.applyInverse(ray), tMin, tMax);
+  }
+
+  virtual int intersectPacket(const RayPacket& packet, int laneMask, Real tMin, Real tMax[],
+                              SInteraction interactions[]) const override {
+    const int hitMask = object->intersectPacket(toObject(packet, laneMask), laneMask, tMin, tMax, interactions);
+    for (int lane = 0; lane < RayPacket::size; lane++)
+      if (RayPacket::isSet(hitMask, lane)) toWorld(interactions[lane]);
+    return hitMask;
+  }
+
+  virtual int occludedPacket(const RayPacket& packet, int laneMask, Real tMin, const Real tMax[]) const override {
+    return object->occludedPacket(toObject(packet, laneMask), laneMask, tMin, tMax);
+  }
+
+  virtual bool computeBoundingBox(Real t0, Real t1, AABB& outputBox) const override {
+    outputBox = boundingBox;
+    return hasBox;
+  }
+
+  void collectMaterials(std::vector<std::shared_ptr<Material>>& materials) const override {
+    object->collectMaterials(materials);
+  }
+};
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef LINEAR_BVH_HPP
+#define LINEAR_BVH_HPP
+
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "../GeoObjects/GeometricalObject.hpp"
+#include "BVHTree.hpp"
+#include "Scene.hpp"
+
+// Bounding volume hierarchy over geometrical objects, stored as a flat node array and traversed iteratively.
+// Drop-in replacement for BVHNode.
+class LinearBVH : public GeometricalObject {
+ private:
+  std::vector<std::shared_ptr<GeoObject>> objects;
+  BVHTree tree;
+  AABB box;
+
+ public:
+  LinearBVH() {}
+  LinearBVH(Scene& scene, Real time0, Real time1, const BVHBuildOptions& options = BVHBuildOptions()) :
+      LinearBVH(scene.getObjects(), time0, time1, options) {}
+  LinearBVH(const std::vector<std::shared_ptr<GeoObject>>& sceneObjects, Real time0, Real time1,
+            const BVHBuildOptions& options = BVHBuildOptions()) {
+    std::vector<AABB> boxes;
+    boxes.reserve(sceneObjects.size());
+    for (const auto& object : sceneObjects) {
+      AABB objectBox;
+      if (!object->computeBoundingBox(time0, time1, objectBox))
+        std::cerr << "No bounding box in LinearBVH ctor." << std::endl;
+      boxes.push_back(objectBox);
+    }
+
+    tree.build(boxes, options);
+
+    // Store the objects in leaf order so leaves address them directly.
+    objects.reserve(sceneObjects.size());
+    for (const auto index : tree.getPrimitiveOrder()) objects.push_back(sceneObjects[index]);
+    if (!tree.empty()) box = tree.getBounds();
+  }
+
+  bool intersect(const Ray& ray, Real tMin, Real tMax, SInteraction& interaction) const override {
+    return tree.intersect(ray, tMin, tMax, [&](uint32_t index, Real& closestSoFar) {
+      if (!objects[index]->intersect(ray, tMin, closestSoFar, interaction)) return false;
+      closestSoFar = interaction.t;
+      return true;
+    });
+  }
+
+  bool occluded(const Ray& ray, Real tMin, Real tMax) const override {
+    return tree.occluded(ray, tMin, tMax, [&](uint32_t index) { return objects[index]->occluded(ray, tMin, tMax); });
+  }
+
+  int intersectPacket(const RayPacket& packet, int laneMask, Real tMin, Real tMax[],
+                      SInteraction interactions[]) const override {
+    return tree.intersect(packet, laneMask, tMin, tMax, [&](uint32_t index, int mask, Real* closestSoFar) {
+      return objects[index]->intersectPacket(packet, mask, tMin, closestSoFar, interactions);
+    });
+  }
+
+  int occludedPacket(const RayPacket& packet, int laneMask, Real tMin, const Real tMax[]) const override {
+    return tree.occluded(packet, laneMask, tMin, tMax, [&](uint32_t index, int mask) {
+      return objects[index]->occludedPacket(packet, mask, tMin, tMax);
+    });
+  }
+
+  bool computeBoundingBox(Real t0, Real t1, AABB& outputBox) const override {
+    outputBox = box;
+    return !tree.empty();
+  }
+
+  void collectMaterials(std::vector<std::shared_ptr<Material>>& materials) const override {
+    for (const auto& object : objects) object->collectMaterials(materials);
+  }
+
+  const BVHTree& getTree() const { return tree; }
+};
+
+#endif
@@ -0,0 +1,696 @@
+#ifndef MESH_LOADER_HPP
+#define MESH_LOADER_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "../GeoObjects/TriangleMesh.hpp"
+
+// Loaders of Wavefront OBJ and binary PLY files into a TriangleMesh with one material. Parsing is split into chunks
+// handed out to threadCount threads. OBJ files are streamed in blocks, so only one block of text is held at a time;
+// materials, groups and lines in them are ignored and polygons are split into fans.
+namespace MeshLoader {
+  struct MeshData {
+    std::vector<Point3> positions;
+    std::vector<Vector3> normals;
+    std::vector<UV> uvs;
+    std::vector<uint32_t> indices;
+  };
+
+  // Calls function(i) for every i in [0, count), handing the indices out in order to up to threadCount threads.
+  template <typename Function>
+  void parallelFor(size_t count, unsigned threadCount, Function function) {
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+      for (size_t i = next++; i < count; i = next++) function(i);
+    };
+    const unsigned workerCount = std::min<size_t>(std::max(threadCount, 1u), count);
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < workerCount; i++) threads.emplace_back(worker);
+    worker();
+    for (auto& thread : threads) thread.join();
+  }
+
+  inline const char* skipSpaces(const char* text, const char* end) {
+    while (text < end && (*text == ' ' || *text == '\t')) text++;
+    return text;
+  }
+
+  inline bool parseInteger(const char*& text, const char* end, int64_t& value) {
+    const char* p = skipSpaces(text, end);
+    const bool negative = p < end && *p == '-';
+    if (p < end && (*p == '-' || *p == '+')) p++;
+    const char* digits = p;
+    value = 0;
+    while (p < end && *p >= '0' && *p <= '9') value = 10 * value + (*p++ - '0');
+    if (p == digits) return false;
+    if (negative) value = -value;
+    text = p;
+    return true;
+  }
+
+  // Decimal number with optional sign, fraction and exponent. Mantissas of up to 18 digits scaled by powers of ten up
+  // to 1e22 are exact, so the result is correctly rounded in the common case; longer ones may be an ulp off.
+  inline bool parseReal(const char*& text, const char* end, double& value) {
+    static const double powersOfTen[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                         1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    const char* p = skipSpaces(text, end);
+    const bool negative = p < end && *p == '-';
+    if (p < end && (*p == '-' || *p == '+')) p++;
+
+    uint64_t mantissa = 0;
+    int exponent = 0, digitCount = 0;
+    for (; p < end && *p >= '0' && *p <= '9'; p++, digitCount++) {
+      if (mantissa < 100000000000000000ull)
+        mantissa = 10 * mantissa + (*p - '0');
+      else
+        exponent++;
+    }
+    if (p < end && *p == '.') {
+      for (p++; p < end && *p >= '0' && *p <= '9'; p++, digitCount++) {
+        if (mantissa < 100000000000000000ull) {
+          mantissa = 10 * mantissa + (*p - '0');
+          exponent--;
+        }
+      }
+    }
+    if (digitCount == 0) return false;
+    if (p < end && (*p == 'e' || *p == 'E')) {
+      const char* exponentText = p + 1;
+      int64_t exponentValue;
+      if (parseInteger(exponentText, end, exponentValue)) {
+        exponent += std::max<int64_t>(std::min<int64_t>(exponentValue, 1000), -1000);
+        p = exponentText;
+      }
+    }
+
+    value = mantissa;
+    if (exponent < 0 && exponent >= -22)
+      value /= powersOfTen[-exponent];
+    else if (exponent > 0 && exponent <= 22)
+      value *= powersOfTen[exponent];
+    else if (exponent != 0)
+      value *= std::pow(10.0, exponent);
+    if (negative) value = -value;
+    text = p;
+    return true;
+  }
+
+  // Face corners are stored 0-based. A negative OBJ index counts back from the vertices read so far, which a chunk
+  // only knows locally; such indices are kept relative to the chunk's first vertex, offset by relativeIndex, until the
+  // chunks are joined. Missing indices are -1.
+  constexpr int64_t relativeIndex = int64_t(1) << 62;
+
+  struct OBJChunk {
+    std::vector<Real> positions;  // three per vertex
+    std::vector<Real> normals;
+    std::vector<Real> uvs;             // two per vertex
+    std::vector<int64_t> corners;      // position, uv and normal index per face corner
+    std::vector<uint32_t> faceSizes;   // corners per face
+  };
+
+  inline int64_t objIndex(int64_t index, size_t readSoFar) {
+    if (index > 0) return index - 1;
+    if (index < 0) return relativeIndex + int64_t(readSoFar) + index;
+    return -1;
+  }
+
+  inline void readReals(const char* text, const char* end, int count, std::vector<Real>& values) {
+    for (int i = 0; i < count; i++) {
+      double value = 0;
+      parseReal(text, end, value);
+      values.push_back(value);
+    }
+  }
+
+  inline void parseOBJ(const char* text, const char* end, OBJChunk& chunk) {
+    while (text < end) {
+      const char* lineEnd = static_cast<const char*>(std::memchr(text, '\n', end - text));
+      if (!lineEnd) lineEnd = end;
+      const char* p = skipSpaces(text, lineEnd);
+      text = lineEnd + 1;
+      if (lineEnd - p < 2) continue;
+
+      if (p[0] == 'v' && (p[1] == ' ' || p[1] == '\t')) {
+        readReals(p + 1, lineEnd, 3, chunk.positions);
+      } else if (p[0] == 'v' && p[1] == 'n') {
+        readReals(p + 2, lineEnd, 3, chunk.normals);
+      } else if (p[0] == 'v' && p[1] == 't') {
+        readReals(p + 2, lineEnd, 2, chunk.uvs);
+      } else if (p[0] == 'f' && (p[1] == ' ' || p[1] == '\t')) {
+        p++;
+        uint32_t cornerCount = 0;
+        int64_t position;
+        while (parseInteger(p, lineEnd, position)) {
+          int64_t uv = 0, normal = 0;
+          if (p < lineEnd && *p == '/') {
+            p++;
+            if (p < lineEnd && *p != '/') parseInteger(p, lineEnd, uv);
+            if (p < lineEnd && *p == '/') {
+              p++;
+              parseInteger(p, lineEnd, normal);
+            }
+          }
+          chunk.corners.push_back(objIndex(position, chunk.positions.size() / 3));
+          chunk.corners.push_back(objIndex(uv, chunk.uvs.size() / 2));
+          chunk.corners.push_back(objIndex(normal, chunk.normals.size() / 3));
+          cornerCount++;
+        }
+        if (cornerCount >= 3)
+          chunk.faceSizes.push_back(cornerCount);
+        else
+          chunk.corners.resize(chunk.corners.size() - 3 * cornerCount);
+      }
+    }
+  }
+
+  // Splits [text, end) at line breaks into about four chunks per thread and parses them in parallel.
+  inline void parseOBJBlock(const char* text, const char* end, unsigned threadCount, std::vector<OBJChunk>& chunks) {
+    const size_t pieceCount = 4 * std::max(threadCount, 1u);
+    const size_t pieceSize = (end - text) / pieceCount + 1;
+    std::vector<const char*> bounds = {text};
+    while (bounds.back() < end) {
+      const char* split = std::min(bounds.back() + pieceSize, end);
+      const char* lineEnd = static_cast<const char*>(std::memchr(split, '\n', end - split));
+      bounds.push_back(lineEnd ? lineEnd + 1 : end);
+    }
+
+    const size_t first = chunks.size();
+    chunks.resize(first + bounds.size() - 1);
+    parallelFor(bounds.size() - 1, threadCount,
+                [&](size_t i) { parseOBJ(bounds[i], bounds[i + 1], chunks[first + i]); });
+  }
+
+  struct CornerHash {
+    size_t operator()(const std::array<int64_t, 3>& corner) const {
+      return std::hash<int64_t>()(corner[0] * 73856093 ^ corner[1] * 19349663 ^ corner[2] * 83492791);
+    }
+  };
+
+  // Joins the chunks: resolves relative indices, gives every distinct (position, uv, normal) corner a vertex and
+  // splits the faces into triangles.
+  inline bool joinOBJChunks(std::vector<OBJChunk>& chunks, MeshData& mesh) {
+    std::vector<Vector3> normals;
+    std::vector<UV> uvs;
+    size_t faceCount = 0;
+    for (auto& chunk : chunks) {
+      // Chunk relative indices become absolute once the vertices before the chunk are known.
+      const int64_t offsets[3] = {int64_t(mesh.positions.size()), int64_t(uvs.size()), int64_t(normals.size())};
+      for (size_t i = 0; i < chunk.corners.size(); i++) {
+        int64_t& index = chunk.corners[i];
+        if (index >= relativeIndex / 2) index = index - relativeIndex + offsets[i % 3];
+      }
+      for (size_t i = 0; i < chunk.positions.size(); i += 3)
+        mesh.positions.push_back(Point3(chunk.positions[i], chunk.positions[i + 1], chunk.positions[i + 2]));
+      for (size_t i = 0; i < chunk.uvs.size(); i += 2) uvs.push_back(UV(chunk.uvs[i], chunk.uvs[i + 1]));
+      for (size_t i = 0; i < chunk.normals.size(); i += 3)
+        normals.push_back(Vector3(chunk.normals[i], chunk.normals[i + 1], chunk.normals[i + 2]));
+      chunk.positions = chunk.uvs = chunk.normals = std::vector<Real>();
+      faceCount += chunk.faceSizes.size();
+    }
+
+    // Out of range texture coordinates and normals are dropped; faces with a bad position are skipped. Corners that
+    // index every array with the position index, as most exporters write them, need no new vertices.
+    const int64_t counts[3] = {int64_t(mesh.positions.size()), int64_t(uvs.size()), int64_t(normals.size())};
+    bool usesUVs = false, usesNormals = false, sharesIndices = true;
+    for (auto& chunk : chunks) {
+      for (size_t i = 0; i < chunk.corners.size(); i += 3) {
+        for (int k = 1; k < 3; k++)
+          if (chunk.corners[i + k] < 0 || chunk.corners[i + k] >= counts[k]) chunk.corners[i + k] = -1;
+        usesUVs |= chunk.corners[i + 1] != -1;
+        usesNormals |= chunk.corners[i + 2] != -1;
+        sharesIndices &= (chunk.corners[i + 1] == -1 || chunk.corners[i + 1] == chunk.corners[i]) &&
+                         (chunk.corners[i + 2] == -1 || chunk.corners[i + 2] == chunk.corners[i]);
+      }
+    }
+
+    if (sharesIndices) {
+      if (usesUVs) {
+        uvs.resize(mesh.positions.size());
+        mesh.uvs = std::move(uvs);
+      }
+      if (usesNormals) {
+        normals.resize(mesh.positions.size());
+        mesh.normals = std::move(normals);
+      }
+    } else {
+      std::vector<Point3> positions = std::move(mesh.positions);
+      mesh.positions.clear();
+      std::unordered_map<std::array<int64_t, 3>, uint32_t, CornerHash> vertices;
+      for (auto& chunk : chunks) {
+        for (size_t i = 0; i < chunk.corners.size(); i += 3) {
+          const std::array<int64_t, 3> corner = {chunk.corners[i], chunk.corners[i + 1], chunk.corners[i + 2]};
+          if (corner[0] < 0 || corner[0] >= counts[0]) {
+            chunk.corners[i] = -1;
+            continue;
+          }
+          const auto inserted = vertices.emplace(corner, mesh.positions.size());
+          if (inserted.second) {
+            mesh.positions.push_back(positions[corner[0]]);
+            if (usesUVs) mesh.uvs.push_back(corner[1] >= 0 ? uvs[corner[1]] : UV());
+            if (usesNormals) mesh.normals.push_back(corner[2] >= 0 ? normals[corner[2]] : Vector3(0, 0, 0));
+          }
+          chunk.corners[i] = inserted.first->second;
+        }
+      }
+    }
+
+    const int64_t vertexCount = mesh.positions.size();
+    size_t skippedFaces = 0;
+    mesh.indices.reserve(3 * faceCount);
+    for (const auto& chunk : chunks) {
+      size_t corner = 0;
+      for (const auto faceSize : chunk.faceSizes) {
+        const int64_t* face = &chunk.corners[3 * corner];
+        corner += faceSize;
+        bool valid = true;
+        for (uint32_t k = 0; k < faceSize; k++) valid &= face[3 * k] >= 0 && face[3 * k] < vertexCount;
+        if (!valid) {
+          skippedFaces++;
+          continue;
+        }
+        for (uint32_t k = 2; k < faceSize; k++) {
+          mesh.indices.push_back(face[0]);
+          mesh.indices.push_back(face[3 * (k - 1)]);
+          mesh.indices.push_back(face[3 * k]);
+        }
+      }
+    }
+    if (skippedFaces > 0) std::cerr << "OBJ: skipped " << skippedFaces << " faces with invalid indices." << std::endl;
+    return true;
+  }
+
+  inline bool readOBJ(const std::string& path, MeshData& mesh, unsigned threadCount) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+      std::cerr << "Cannot open " << path << std::endl;
+      return false;
+    }
+
+    // Blocks end at the last line break; the rest is carried over to the next block.
+    const size_t blockSize = size_t(1) << 25;
+    std::vector<OBJChunk> chunks;
+    std::vector<char> text;
+    size_t carried = 0;
+    while (true) {
+      text.resize(carried + blockSize);
+      file.read(text.data() + carried, blockSize);
+      const size_t size = carried + file.gcount();
+      const bool isLast = !file;
+      size_t parsedSize = size;
+      if (!isLast) {
+        while (parsedSize > 0 && text[parsedSize - 1] != '\n') parsedSize--;
+        if (parsedSize == 0) {
+          carried = size;
+          continue;
+        }
+      }
+      parseOBJBlock(text.data(), text.data() + parsedSize, threadCount, chunks);
+      carried = size - parsedSize;
+      std::memmove(text.data(), text.data() + parsedSize, carried);
+      if (isLast) break;
+    }
+    text = std::vector<char>();
+    return joinOBJChunks(chunks, mesh);
+  }
+
+  enum class PLYType { Int8, UInt8, Int16, UInt16, Int32, UInt32, Float32, Float64 };
+
+  struct PLYProperty {
+    std::string name;
+    PLYType type;
+    bool isList = false;
+    PLYType countType;  // of lists, whose items are of type
+  };
+
+  struct PLYElement {
+    std::string name;
+    size_t count = 0;
+    std::vector<PLYProperty> properties;
+  };
+
+  inline bool parsePLYType(const std::string& name, PLYType& type) {
+    static const std::pair<const char*, PLYType> names[] = {
+        {"char", PLYType::Int8},     {"int8", PLYType::Int8},       {"uchar", PLYType::UInt8},
+        {"uint8", PLYType::UInt8},   {"short", PLYType::Int16},     {"int16", PLYType::Int16},
+        {"ushort", PLYType::UInt16}, {"uint16", PLYType::UInt16},   {"int", PLYType::Int32},
+        {"int32", PLYType::Int32},   {"uint", PLYType::UInt32},     {"uint32", PLYType::UInt32},
+        {"float", PLYType::Float32}, {"float32", PLYType::Float32}, {"double", PLYType::Float64},
+        {"float64", PLYType::Float64}};
+    for (const auto& entry : names) {
+      if (name == entry.first) {
+        type = entry.second;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  inline size_t plyTypeSize(PLYType type) {
+    switch (type) {
+      case PLYType::Int8:
+      case PLYType::UInt8: return 1;
+      case PLYType::Int16:
+      case PLYType::UInt16: return 2;
+      case PLYType::Int32:
+      case PLYType::UInt32:
+      case PLYType::Float32: return 4;
+      default: return 8;
+    }
+  }
+
+  template <typename T>
+  T readPLYBytes(const char* data, bool swapBytes) {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, data, sizeof(T));
+    if (swapBytes) std::reverse(bytes, bytes + sizeof(T));
+    T value;
+    std::memcpy(&value, bytes, sizeof(T));
+    return value;
+  }
+
+  inline double readPLYValue(const char* data, PLYType type, bool swapBytes) {
+    switch (type) {
+      case PLYType::Int8: return readPLYBytes<int8_t>(data, swapBytes);
+      case PLYType::UInt8: return readPLYBytes<uint8_t>(data, swapBytes);
+      case PLYType::Int16: return readPLYBytes<int16_t>(data, swapBytes);
+      case PLYType::UInt16: return readPLYBytes<uint16_t>(data, swapBytes);
+      case PLYType::Int32: return readPLYBytes<int32_t>(data, swapBytes);
+      case PLYType::UInt32: return readPLYBytes<uint32_t>(data, swapBytes);
+      case PLYType::Float32: return readPLYBytes<float>(data, swapBytes);
+      default: return readPLYBytes<double>(data, swapBytes);
+    }
+  }
+
+  inline bool isPLYInteger(PLYType type) { return type != PLYType::Float32 && type != PLYType::Float64; }
+
+  // List counts and vertex indices; the header guarantees an integer type.
+  inline int64_t readPLYInteger(const char* data, PLYType type, bool swapBytes) {
+    switch (type) {
+      case PLYType::Int8: return readPLYBytes<int8_t>(data, swapBytes);
+      case PLYType::UInt8: return readPLYBytes<uint8_t>(data, swapBytes);
+      case PLYType::Int16: return readPLYBytes<int16_t>(data, swapBytes);
+      case PLYType::UInt16: return readPLYBytes<uint16_t>(data, swapBytes);
+      case PLYType::Int32: return readPLYBytes<int32_t>(data, swapBytes);
+      default: return readPLYBytes<uint32_t>(data, swapBytes);
+    }
+  }
+
+  // Size of the property at data, or 0 if it runs past end.
+  inline size_t plyPropertySize(const PLYProperty& property, const char* data, const char* end, bool swapBytes) {
+    size_t size = plyTypeSize(property.type);
+    if (property.isList) {
+      const size_t countSize = plyTypeSize(property.countType);
+      if (countSize > size_t(end - data)) return 0;
+      const int64_t count = readPLYInteger(data, property.countType, swapBytes);
+      if (count < 0) return 0;
+      size = countSize + size_t(count) * size;
+    }
+    return size > size_t(end - data) ? 0 : size;
+  }
+
+  // Size of the record at data, or 0 if it runs past end.
+  inline size_t plyRecordSize(const PLYElement& element, const char* data, const char* end, bool swapBytes) {
+    size_t size = 0;
+    for (const auto& property : element.properties) {
+      const size_t propertySize = plyPropertySize(property, data + size, end, swapBytes);
+      if (propertySize == 0) return 0;
+      size += propertySize;
+    }
+    return size;
+  }
+
+  inline bool readPLYHeader(std::istream& in, std::vector<PLYElement>& elements, bool& bigEndian) {
+    std::string line;
+    if (!std::getline(in, line) || line.compare(0, 3, "ply") != 0) {
+      std::cerr << "PLY: not a PLY file." << std::endl;
+      return false;
+    }
+    while (std::getline(in, line)) {
+      if (!line.empty() && line.back() == '\r') line.pop_back();
+      std::istringstream tokens(line);
+      std::string keyword;
+      tokens >> keyword;
+      if (keyword == "format") {
+        std::string format;
+        tokens >> format;
+        if (format != "binary_little_endian" && format != "binary_big_endian") {
+          std::cerr << "PLY: only binary files are supported, not " << format << "." << std::endl;
+          return false;
+        }
+        bigEndian = format == "binary_big_endian";
+      } else if (keyword == "element") {
+        elements.emplace_back();
+        tokens >> elements.back().name >> elements.back().count;
+      } else if (keyword == "property" && !elements.empty()) {
+        PLYProperty property;
+        std::string type;
+        tokens >> type;
+        if (type == "list") {
+          std::string countType;
+          tokens >> countType >> type;
+          property.isList = true;
+          if (!parsePLYType(countType, property.countType)) type = countType;
+        }
+        if (!parsePLYType(type, property.type)) {
+          std::cerr << "PLY: unknown property type " << type << "." << std::endl;
+          return false;
+        }
+        tokens >> property.name;
+        const bool indexList = property.name == "vertex_indices" || property.name == "vertex_index";
+        if (property.isList && (!isPLYInteger(property.countType) || (indexList && !isPLYInteger(property.type)))) {
+          std::cerr << "PLY: list " << property.name << " needs integer counts and indices." << std::endl;
+          return false;
+        }
+        elements.back().properties.push_back(property);
+      } else if (keyword == "end_header") {
+        return true;
+      }
+    }
+    std::cerr << "PLY: no end_header." << std::endl;
+    return false;
+  }
+
+  // Vertex records are fixed size, so they are decoded in parallel ranges. Texture coordinates may be named u/v, s/t
+  // or texture_u/texture_v.
+  inline bool readPLYVertices(const PLYElement& element, const char* data, bool swapBytes, unsigned threadCount,
+                              MeshData& mesh) {
+    int offsets[8];
+    std::fill(offsets, offsets + 8, -1);
+    const char* names[8][3] = {{"x", "x", "x"},          {"y", "y", "y"},   {"z", "z", "z"},
+                               {"nx", "nx", "nx"},       {"ny", "ny", "ny"}, {"nz", "nz", "nz"},
+                               {"u", "s", "texture_u"}, {"v", "t", "texture_v"}};
+    PLYType types[8];
+    size_t stride = 0;
+    for (const auto& property : element.properties) {
+      for (int i = 0; i < 8; i++) {
+        if (property.name == names[i][0] || property.name == names[i][1] || property.name == names[i][2]) {
+          offsets[i] = stride;
+          types[i] = property.type;
+        }
+      }
+      stride += plyTypeSize(property.type);
+    }
+    if (offsets[0] < 0 || offsets[1] < 0 || offsets[2] < 0) {
+      std::cerr << "PLY: vertices without x, y and z." << std::endl;
+      return false;
+    }
+    const bool hasNormals = offsets[3] >= 0 && offsets[4] >= 0 && offsets[5] >= 0;
+    const bool hasUVs = offsets[6] >= 0 && offsets[7] >= 0;
+
+    const size_t count = element.count;
+    mesh.positions.resize(count);
+    if (hasNormals) mesh.normals.resize(count);
+    if (hasUVs) mesh.uvs.resize(count);
+    auto value = [&](const char* record, int i) { return readPLYValue(record + offsets[i], types[i], swapBytes); };
+    const size_t rangeSize = count / (4 * std::max(threadCount, 1u)) + 1;
+    parallelFor((count + rangeSize - 1) / rangeSize, threadCount, [&](size_t range) {
+      for (size_t i = range * rangeSize; i < std::min(count, (range + 1) * rangeSize); i++) {
+        const char* record = data + i * stride;
+        mesh.positions[i] = Point3(value(record, 0), value(record, 1), value(record, 2));
+        if (hasNormals) mesh.normals[i] = Vector3(value(record, 3), value(record, 4), value(record, 5));
+        if (hasUVs) mesh.uvs[i] = UV(value(record, 6), value(record, 7));
+      }
+    });
+    return true;
+  }
+
+  // Faces that are all triangles have fixed size records and are decoded in parallel; anything else, or a face list
+  // that is not the only list, is walked serially and split into fans. Returns the bytes read, 0 on error.
+  inline size_t readPLYFaces(const PLYElement& element, const char* data, const char* end, bool swapBytes,
+                             unsigned threadCount, MeshData& mesh) {
+    int listIndex = -1, listCount = 0;
+    size_t before = 0, after = 0;
+    for (size_t i = 0; i < element.properties.size(); i++) {
+      const PLYProperty& property = element.properties[i];
+      if (property.isList) {
+        listCount++;
+        if (property.name == "vertex_indices" || property.name == "vertex_index") listIndex = i;
+      } else {
+        (listIndex < 0 ? before : after) += plyTypeSize(property.type);
+      }
+    }
+    if (listIndex < 0) {
+      std::cerr << "PLY: faces without vertex_indices." << std::endl;
+      return 0;
+    }
+    const PLYProperty& list = element.properties[listIndex];
+    const size_t countSize = plyTypeSize(list.countType);
+    const size_t indexSize = plyTypeSize(list.type);
+    const size_t count = element.count;
+
+    if (listCount == 1) {
+      const size_t stride = before + countSize + 3 * indexSize + after;
+      if (count <= size_t(end - data) / stride) {
+        std::atomic<bool> allTriangles(true), negativeIndex(false);
+        mesh.indices.resize(3 * count);
+        const size_t rangeSize = count / (4 * std::max(threadCount, 1u)) + 1;
+        parallelFor((count + rangeSize - 1) / rangeSize, threadCount, [&](size_t range) {
+          for (size_t i = range * rangeSize; i < std::min(count, (range + 1) * rangeSize) && allTriangles; i++) {
+            const char* record = data + i * stride + before;
+            if (readPLYInteger(record, list.countType, swapBytes) != 3) {
+              allTriangles = false;
+              break;
+            }
+            for (int k = 0; k < 3; k++) {
+              const int64_t index = readPLYInteger(record + countSize + k * indexSize, list.type, swapBytes);
+              if (index < 0) negativeIndex = true;
+              mesh.indices[3 * i + k] = uint32_t(index);
+            }
+          }
+        });
+        if (negativeIndex) {
+          std::cerr << "PLY: negative vertex index." << std::endl;
+          return 0;
+        }
+        if (allTriangles) return count * stride;
+        mesh.indices.clear();
+      }
+    }
+
+    const char* record = data;
+    for (size_t i = 0; i < count; i++) {
+      const size_t size = plyRecordSize(element, record, end, swapBytes);
+      if (size == 0) {
+        std::cerr << "PLY: file ends within the faces." << std::endl;
+        return 0;
+      }
+      const char* field = record;
+      for (int p = 0; p < listIndex; p++) field += plyPropertySize(element.properties[p], field, end, swapBytes);
+      const size_t cornerCount = readPLYInteger(field, list.countType, swapBytes);
+      const char* indices = field + countSize;
+      for (size_t k = 0; k < cornerCount; k++) {
+        if (readPLYInteger(indices + k * indexSize, list.type, swapBytes) < 0) {
+          std::cerr << "PLY: negative vertex index." << std::endl;
+          return 0;
+        }
+      }
+      for (size_t k = 2; k < cornerCount; k++) {
+        mesh.indices.push_back(readPLYInteger(indices, list.type, swapBytes));
+        mesh.indices.push_back(readPLYInteger(indices + (k - 1) * indexSize, list.type, swapBytes));
+        mesh.indices.push_back(readPLYInteger(indices + k * indexSize, list.type, swapBytes));
+      }
+      record += size;
+    }
+    return record - data;
+  }
+
+  inline bool readPLY(const std::string& path, MeshData& mesh, unsigned threadCount) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+      std::cerr << "Cannot open " << path << std::endl;
+      return false;
+    }
+    std::vector<PLYElement> elements;
+    bool bigEndian = false;
+    if (!readPLYHeader(file, elements, bigEndian)) return false;
+
+    // The body is read at once: binary records are decoded in place.
+    const std::streampos bodyStart = file.tellg();
+    file.seekg(0, std::ios::end);
+    std::vector<char> body(file.tellg() - bodyStart);
+    file.seekg(bodyStart);
+    file.read(body.data(), body.size());
+
+    const uint16_t probe = 1;
+    const bool hostBigEndian = *reinterpret_cast<const uint8_t*>(&probe) == 0;
+    const bool swapBytes = bigEndian != hostBigEndian;
+
+    const char* data = body.data();
+    const char* end = data + body.size();
+    for (const auto& element : elements) {
+      bool hasLists = false;
+      size_t stride = 0;
+      for (const auto& property : element.properties) {
+        hasLists |= property.isList;
+        stride += plyTypeSize(property.type);
+      }
+
+      if (element.name == "face") {
+        const size_t size = readPLYFaces(element, data, end, swapBytes, threadCount, mesh);
+        if (size == 0 && element.count > 0) return false;
+        data += size;
+      } else if (!hasLists) {
+        if (stride > 0 && element.count > size_t(end - data) / stride) {
+          std::cerr << "PLY: file ends within the " << element.name << " elements." << std::endl;
+          return false;
+        }
+        if (element.name == "vertex" && !readPLYVertices(element, data, swapBytes, threadCount, mesh)) return false;
+        data += element.count * stride;
+      } else {
+        for (size_t i = 0; i < element.count; i++) {
+          const size_t size = plyRecordSize(element, data, end, swapBytes);
+          if (size == 0) {
+            std::cerr << "PLY: file ends within the " << element.name << " elements." << std::endl;
+            return false;
+          }
+          data += size;
+        }
+      }
+    }
+
+    const size_t vertexCount = mesh.positions.size();
+    for (const auto index : mesh.indices) {
+      if (index >= vertexCount) {
+        std::cerr << "PLY: vertex index " << index << " out of range." << std::endl;
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Reads an .obj or binary .ply file. Returns nullptr, after saying why, if it cannot.
+  inline std::shared_ptr<TriangleMesh> load(const std::string& path, std::shared_ptr<Material> material,
+                                            unsigned threadCount = std::thread::hardware_concurrency()) {
+    std::string extension = path.substr(path.find_last_of('.') + 1);
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+
+    MeshData mesh;
+    bool loaded = false;
+    if (extension == "obj")
+      loaded = readOBJ(path, mesh, threadCount);
+    else if (extension == "ply")
+      loaded = readPLY(path, mesh, threadCount);
+    else
+      std::cerr << "Unknown mesh format: " << path << std::endl;
+    if (!loaded) return nullptr;
+
+    return std::make_shared<TriangleMesh>(std::move(mesh.positions), std::move(mesh.indices), material,
+                                          std::move(mesh.normals), std::move(mesh.uvs));
+  }
+}
+
+#endif
@@ -82,7 +82,7 @@ class PerlinNoise {
     auto accum = 0.0;
     auto factorPoint = point;
     auto weight = 1.0;
-    for (size_t i = 0; i < depth; ++i) {
+    for (int i = 0; i < depth; ++i) {
       accum += weight * noise(factorPoint);
       weight *= 0.5;
       factorPoint *= 2;
@@ -7,20 +7,20 @@
 class RotateY : public GeometricalObject {
  private:
   std::shared_ptr<GeometricalObject> object;
-  double sinTheta;
-  double cosTheta;
+  Real sinTheta;
+  Real cosTheta;
   bool hasBox;
   AABB boundingBox;
 
  public:
-  RotateY(std::shared_ptr<GeoObject> object, double angle) : object(object) {
+  RotateY(std::shared_ptr<GeoObject> object, Real angle) : object(object) {
     const auto radians = Math::degreesToRadians(angle);
     sinTheta = std::sin(radians);
     cosTheta = std::cos(radians);
     hasBox = object->computeBoundingBox(0, 1, boundingBox);
 
-    Point3 min(Math::infinity, Math::infinity, Math::infinity);
-    Point3 max(-Math::infinity, -Math::infinity, -Math::infinity);
+    Point3 min(Math::realInfinity, Math::realInfinity, Math::realInfinity);
+    Point3 max(-Math::realInfinity, -Math::realInfinity, -Math::realInfinity);
 
     for (size_t i = 0; i < 2; ++i) {
       for (size_t j = 0; j < 2; ++j) {
@@ -44,7 +44,8 @@ class RotateY : public GeometricalObject {
     boundingBox = AABB(min, max);
   }
 
-  virtual bool intersect(const Ray& ray, double tMin, double tMax, SInteraction& interaction) const override {
+  // Ray in the object's frame.
+  Ray rotateRay(const Ray& ray) const {
     auto origin = ray.origin;
     auto direction = ray.direction;
 
@@ -54,10 +55,11 @@ class RotateY : public GeometricalObject {
     direction[0] = cosTheta * ray.direction[0] - sinTheta * ray.direction[2];
     direction[2] = sinTheta * ray.direction[0] + cosTheta * ray.direction[2];
 
-    const Ray rotatedRay(origin, direction, ray.getTime());
-
-    if (!object->intersect(rotatedRay, tMin, tMax, interaction)) return false;
+    return Ray(origin, direction, ray.getTime());
+  }
 
+  // Takes a hit found with the rotated ray back to world space.
+  void rotateInteraction(const Ray& rotatedRay, SInteraction& interaction) const {
     auto point = interaction.point;
     auto normal = interaction.normal;
 
@@ -69,14 +71,49 @@ class RotateY : public GeometricalObject {
 
     interaction.point = point;
     interaction.setFaceNormal(rotatedRay, normal);
+  }
+
+  RayPacket rotatePacket(const RayPacket& packet, int laneMask) const {
+    RayPacket rotatedPacket;
+    for (int lane = 0; lane < RayPacket::size; lane++)
+      if (RayPacket::isSet(laneMask, lane)) rotatedPacket.set(lane, rotateRay(packet.rays[lane]));
+    return rotatedPacket;
+  }
+
+  virtual bool intersect(const Ray& ray, Real tMin, Real tMax, SInteraction& interaction) const override {
+    const Ray rotatedRay = rotateRay(ray);
+
+    if (!object->intersect(rotatedRay, tMin, tMax, interaction)) return false;
 
+    rotateInteraction(rotatedRay, interaction);
     return true;
   }
 
-  virtual bool computeBoundingBox(double t0, double t1, AABB& outputBox) const override {
+  virtual bool occluded(const Ray& ray, Real tMin, Real tMax) const override {
+    return object->occluded(rotateRay(ray), tMin, tMax);
+  }
+
+  virtual int intersectPacket(const RayPacket& packet, int laneMask, Real tMin, Real tMax[],
+                              SInteraction interactions[]) const override {
+    const RayPacket rotatedPacket = rotatePacket(packet, laneMask);
+    const int hitMask = object->intersectPacket(rotatedPacket, laneMask, tMin, tMax, interactions);
+    for (int lane = 0; lane < RayPacket::size; lane++)
+      if (RayPacket::isSet(hitMask, lane)) rotateInteraction(rotatedPacket.rays[lane], interactions[lane]);
+    return hitMask;
+  }
+
+  virtual int occludedPacket(const RayPacket& packet, int laneMask, Real tMin, const Real tMax[]) const override {
+    return object->occludedPacket(rotatePacket(packet, laneMask), laneMask, tMin, tMax);
+  }
+
+  virtual bool computeBoundingBox(Real t0, Real t1, AABB& outputBox) const override {
     outputBox = boundingBox;
     return hasBox;
   }
+
+  void collectMaterials(std::vector<std::shared_ptr<Material>>& materials) const override {
+    object->collectMaterials(materials);
+  }
 };
 
 #endif
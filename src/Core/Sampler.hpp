@@ -22,9 +22,9 @@ class Sampler {
 
   Sampler(const Config& config) : Sampler(config.imageHeight, config.imageWidth, config.samplesPerPixel) {}
 
-  Point2 getRandomSample(ushort pixelX, ushort pixelY) const {
-    const double u = (pixelX + Random::fraction()) / (imageWidth - 1);
-    const double v = (pixelY + Random::fraction()) / (imageHeight - 1);
+  Point2 getRandomSample(ushort pixelX, ushort pixelY, RNG& rng) const {
+    const double u = (pixelX + Random::fraction(rng)) / (imageWidth - 1);
+    const double v = (pixelY + Random::fraction(rng)) / (imageHeight - 1);
     return Point2(u, v);
   }
 
@@ -46,11 +46,11 @@ class Sampler {
     return Point2(u, v);
   }
 
-  Point2 getStratifiedSample(ushort pixelX, ushort pixelY, ushort index) const {
+  Point2 getStratifiedSample(ushort pixelX, ushort pixelY, ushort index, RNG& rng) const {
     const ushort i = index % samplesPerEdge;
     const ushort j = index / samplesPerEdge;
-    const double offsetX = i / samplesPerEdge + 1 / (2 * samplesPerEdge) + (Random::fraction() - 0.5) / samplesPerEdge;
-    const double offsetY = j / samplesPerEdge + 1 / (2 * samplesPerEdge) + (Random::fraction() - 0.5) / samplesPerEdge;
+    const double offsetX = i / samplesPerEdge + 1 / (2 * samplesPerEdge) + (Random::fraction(rng) - 0.5) / samplesPerEdge;
+    const double offsetY = j / samplesPerEdge + 1 / (2 * samplesPerEdge) + (Random::fraction(rng) - 0.5) / samplesPerEdge;
     const double u = (pixelX + offsetX) / (imageWidth - 1);
     const double v = (pixelY + offsetY) / (imageHeight - 1);
     return Point2(u, v);
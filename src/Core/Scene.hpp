@@ -2,17 +2,49 @@
 #define SCENE_HPP
 
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include "../GeoObjects/AxisAlignedRectangle.hpp"
 #include "../GeoObjects/GeometricalObject.hpp"
 #include "../GeoObjects/Sphere.hpp"
 #include "../Materials/Material.hpp"
+#include "BVHTree.hpp"
 
+// A list of objects. commit() builds a BVH over them which every later intersect() goes through; until then (and
+// after any add()) the list is searched linearly. Participating media are kept in a list of their own: paths sample
+// them with the overloads taking an RNG, shadow rays and connections weight by their transmittance.
 class Scene : public GeometricalObject {
  private:
   std::vector<std::shared_ptr<GeoObject>> objects;
   std::vector<std::shared_ptr<GeoObject>> lights;
+  std::vector<std::shared_ptr<GeoObject>> media;
+
+  // Acceleration structure, valid while committed. The pointers are owned by objects.
+  BVHTree accelerator;
+  std::vector<const GeoObject*> bvhObjects;
+  std::vector<const GeoObject*> unboundedObjects;
+  bool committed = false;
+
+  // Every material of the objects, addressed by the id materialIds gives it. Path vertices refer to materials through
+  // it. materialVariants holds the same materials as values for the statically dispatched shading path. The ids belong
+  // to this scene, so materials can be shared with other scenes.
+  std::vector<std::shared_ptr<Material>> materials;
+  std::vector<MaterialVariant> materialVariants;
+  std::unordered_map<const Material*, uint32_t> materialIds;
+
+  void buildMaterialTable() {
+    std::vector<std::shared_ptr<Material>> found;
+    collectMaterials(found);
+    materials.clear();
+    materialVariants.clear();
+    materialIds.clear();
+    for (const auto& material : found) {
+      if (!materialIds.emplace(material.get(), materials.size()).second) continue;
+      materials.push_back(material);
+      materialVariants.push_back(material->toVariant());
+    }
+  }
 
  public:
   Scene() {}
@@ -21,13 +53,64 @@ class Scene : public GeometricalObject {
   std::vector<std::shared_ptr<GeoObject>>& getObjects() { return objects; }
 
   void add(std::shared_ptr<GeoObject> object) {
+    if (object->isMedium()) {
+      media.push_back(object);
+      committed = false;
+      return;
+    }
     objects.push_back(object);
-    if (object->getMaterial() != nullptr && dynamic_cast<DiffuseLight*>(&*(object->getMaterial())))
-      lights.push_back(object);
+    if (object->getMaterial() != nullptr && object->getMaterial()->isEmissive()) lights.push_back(object);
+    committed = false;
   }
-  void clear() { objects.clear(); }
+  void clear() {
+    objects.clear();
+    media.clear();
+    committed = false;
+  }
+
+  // Builds the acceleration structure and the material table over the current objects. Cheap to call again if nothing
+  // changed.
+  void commit(Real time0 = 0.0, Real time1 = 1.0, const BVHBuildOptions& options = BVHBuildOptions()) {
+    if (committed) return;
+
+    std::vector<AABB> boxes;
+    std::vector<const GeoObject*> boundedObjects;
+    unboundedObjects.clear();
+    for (const auto& object : objects) {
+      AABB box;
+      if (object->computeBoundingBox(time0, time1, box)) {
+        boxes.push_back(box);
+        boundedObjects.push_back(object.get());
+      } else {
+        unboundedObjects.push_back(object.get());
+      }
+    }
+
+    accelerator.build(boxes, options);
+    bvhObjects.clear();
+    bvhObjects.reserve(boundedObjects.size());
+    for (const auto index : accelerator.getPrimitiveOrder()) bvhObjects.push_back(boundedObjects[index]);
+    buildMaterialTable();
+    committed = true;
+  }
+
+  bool isCommitted() const { return committed; }
+
+  // Id of a material of the committed objects in the material table.
+  uint32_t getMaterialId(const Material& material) const { return materialIds.at(&material); }
+  const Material& getMaterialById(uint32_t id) const { return *materials[id]; }
+  const MaterialVariant& getMaterialVariant(uint32_t id) const { return materialVariants[id]; }
+  const std::vector<MaterialVariant>& getMaterialVariants() const { return materialVariants; }
+  size_t getMaterialCount() const { return materials.size(); }
+
+  void collectMaterials(std::vector<std::shared_ptr<Material>>& found) const override {
+    for (const auto& object : objects) object->collectMaterials(found);
+    for (const auto& medium : media) medium->collectMaterials(found);
+  }
+
+  virtual bool intersect(const Ray& ray, Real tMin, Real tMax, SInteraction& interaction) const override {
+    if (committed) return intersectCommitted(ray, tMin, tMax, interaction);
 
-  virtual bool intersect(const Ray& ray, double tMin, double tMax, SInteraction& interaction) const override {
     SInteraction record;
     bool hitAnything = false;
     auto closestSoFar = tMax;
@@ -36,12 +119,116 @@ class Scene : public GeometricalObject {
         hitAnything = true;
         closestSoFar = record.t;
         interaction = record;
+        interaction.objectPtr = object.get();
       }
     }
     return hitAnything;
   }
 
-  virtual bool computeBoundingBox(double t0, double t1, AABB& outputBox) const override {
+  bool intersectCommitted(const Ray& ray, Real tMin, Real tMax, SInteraction& interaction) const {
+    bool hitAnything = accelerator.intersect(ray, tMin, tMax, [&](uint32_t index, Real& closestSoFar) {
+      if (!bvhObjects[index]->intersect(ray, tMin, closestSoFar, interaction)) return false;
+      closestSoFar = interaction.t;
+      interaction.objectPtr = bvhObjects[index];
+      return true;
+    });
+
+    auto closestSoFar = hitAnything ? interaction.t : tMax;
+    for (const auto object : unboundedObjects) {
+      if (object->intersect(ray, tMin, closestSoFar, interaction)) {
+        hitAnything = true;
+        closestSoFar = interaction.t;
+        interaction.objectPtr = object;
+      }
+    }
+    return hitAnything;
+  }
+
+  virtual bool occluded(const Ray& ray, Real tMin, Real tMax) const override {
+    if (!committed) {
+      for (const auto& object : objects)
+        if (object->occluded(ray, tMin, tMax)) return true;
+      return false;
+    }
+
+    auto isOccluded = [&](uint32_t index) { return bvhObjects[index]->occluded(ray, tMin, tMax); };
+    if (accelerator.occluded(ray, tMin, tMax, isOccluded)) return true;
+    for (const auto object : unboundedObjects)
+      if (object->occluded(ray, tMin, tMax)) return true;
+    return false;
+  }
+
+  virtual int intersectPacket(const RayPacket& packet, int laneMask, Real tMin, Real tMax[],
+                              SInteraction interactions[]) const override {
+    // The lanes an object reports are the ones whose closest hit it just became.
+    auto intersectObject = [&](const GeoObject* object, int mask, Real* closestSoFar) {
+      const int objectMask = object->intersectPacket(packet, mask, tMin, closestSoFar, interactions);
+      for (int lane = 0; lane < RayPacket::size; lane++)
+        if (RayPacket::isSet(objectMask, lane)) interactions[lane].objectPtr = object;
+      return objectMask;
+    };
+    int hitMask = 0;
+    if (committed) {
+      hitMask = accelerator.intersect(packet, laneMask, tMin, tMax, [&](uint32_t index, int mask, Real* closestSoFar) {
+        return intersectObject(bvhObjects[index], mask, closestSoFar);
+      });
+      for (const auto object : unboundedObjects) hitMask |= intersectObject(object, laneMask, tMax);
+    } else {
+      for (const auto& object : objects) hitMask |= intersectObject(object.get(), laneMask, tMax);
+    }
+    return hitMask & laneMask;
+  }
+
+  virtual int occludedPacket(const RayPacket& packet, int laneMask, Real tMin, const Real tMax[]) const override {
+    int blockedMask = 0;
+    if (committed) {
+      blockedMask = accelerator.occluded(packet, laneMask, tMin, tMax, [&](uint32_t index, int mask) {
+        return bvhObjects[index]->occludedPacket(packet, mask, tMin, tMax);
+      });
+      for (const auto object : unboundedObjects)
+        if ((laneMask & ~blockedMask) != 0)
+          blockedMask |= object->occludedPacket(packet, laneMask & ~blockedMask, tMin, tMax);
+    } else {
+      for (const auto& object : objects)
+        if ((laneMask & ~blockedMask) != 0)
+          blockedMask |= object->occludedPacket(packet, laneMask & ~blockedMask, tMin, tMax);
+    }
+    return blockedMask & laneMask;
+  }
+
+  // Free flight through the media along (tMin, tMax). Every medium draws one number from nextRandom(), so a path
+  // reads as many per segment whether it scatters or not; the closest scatter replaces interaction.
+  template <typename NextRandom>
+  bool scatterInMedia(const Ray& ray, Real tMin, Real tMax, NextRandom&& nextRandom, SInteraction& interaction) const {
+    bool scattered = false;
+    for (const auto& medium : media) {
+      const double random = nextRandom();
+      if (medium->sampleFreeFlight(ray, tMin, tMax, random, interaction)) {
+        interaction.objectPtr = medium.get();
+        tMax = interaction.t;
+        scattered = true;
+      }
+    }
+    return scattered;
+  }
+
+  // Closest hit of a path segment: a surface, or a medium scattering the ray before it gets there.
+  bool intersect(const Ray& ray, Real tMin, Real tMax, SInteraction& interaction, RNG& rng) const {
+    const bool hit = intersect(ray, tMin, tMax, interaction);
+    const auto nextRandom = [&rng]() { return Random::fraction(rng); };
+    return scatterInMedia(ray, tMin, hit ? interaction.t : tMax, nextRandom, interaction) || hit;
+  }
+
+  // Fraction of the light along (tMin, tMax) that no medium scatters away.
+  double transmittance(const Ray& ray, Real tMin, Real tMax) const {
+    double fraction = 1;
+    for (const auto& medium : media) fraction *= medium->transmittance(ray, tMin, tMax);
+    return fraction;
+  }
+
+  size_t getMediumCount() const { return media.size(); }
+
+  virtual bool computeBoundingBox(Real t0, Real t1, AABB& outputBox) const override {
     if (objects.empty()) return false;
 
     bool firstBox = true;
@@ -55,15 +242,15 @@ class Scene : public GeometricalObject {
     return true;
   }
 
-  virtual Point3 samplePoint() const override { return Point3(0, 0, 0); }
+  virtual Point3 samplePoint(RNG& rng) const override { return Point3(0, 0, 0); }
 
-  std::shared_ptr<GeoObject> getRandomLight() const {
+  std::shared_ptr<GeoObject> getRandomLight(RNG& rng) const {
     if (lights.size() == 0)
       return nullptr;
     else if (lights.size() == 1)
       return lights[0];
     else
-      return lights[Random::rangeInt(0, lights.size())];
+      return lights[Random::rangeInt(rng, 0, lights.size())];
   }
 
   std::vector<std::shared_ptr<GeoObject>> getLights() const { return lights; }
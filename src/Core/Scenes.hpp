@@ -14,10 +14,13 @@
 #include "../Textures/ImageTexture.hpp"
 #include "../Textures/PerlinTexture.hpp"
 #include "../Textures/SolidColor.hpp"
-#include "BVHNode.hpp"
 #include "Configuration.hpp"
+#include "Instance.hpp"
+#include "LinearBVH.hpp"
+#include "MeshLoader.hpp"
 #include "Rotate.hpp"
 #include "Scene.hpp"
+#include "Stopwatch.hpp"
 #include "Translate.hpp"
 
 namespace Scenes {
@@ -232,10 +235,8 @@ namespace Scenes {
     return scene;
   }
 
-  Scene finalScene() {
-    Scene scene;
-
-    // Ground
+  // 20x20 boxes of random height, the ground of the final scene.
+  Scene boxGround() {
     Scene ground;
     auto groundMat = std::make_shared<Lambertian>(Color(0.48, 0.83, 0.53));
 
@@ -253,8 +254,70 @@ namespace Scenes {
         ground.add(std::make_shared<Box>(Point3(x0, y0, z0), Point3(x1, y1, z1), groundMat));
       }
     }
+    return ground;
+  }
+
+  // The walls and light of the Cornell box around a mesh file, scaled to 330 units and standing in the middle of the
+  // floor. Without a readable file the box stays empty.
+  Scene cornellMesh(const std::string& meshFile, unsigned threadCount) {
+    Scene scene;
+
+    auto red = std::make_shared<Lambertian>(Color(.65, .05, .05));
+    auto white = std::make_shared<Lambertian>(Color(.73, .73, .73));
+    auto green = std::make_shared<Lambertian>(Color(.12, .45, .15));
+    auto light = std::make_shared<DiffuseLight>(Color(15, 15, 15));
+
+    scene.add(std::make_shared<RectangleYZ>(RectangleYZ({0, 555, 0, 555}, 555, red)));
+    scene.add(std::make_shared<RectangleYZ>(RectangleYZ({0, 555, 0, 555}, 0, green)));
+    scene.add(std::make_shared<RectangleXZ>(RectangleXZ({213, 343, 227, 332}, 554, light, 1)));
+    scene.add(std::make_shared<RectangleXZ>(RectangleXZ({0, 555, 0, 555}, 0, white)));
+    scene.add(std::make_shared<RectangleXZ>(RectangleXZ({0, 555, 0, 555}, 555, white)));
+    scene.add(std::make_shared<RectangleXY>(RectangleXY({0, 555, 0, 555}, 555, white)));
+
+    if (meshFile.empty()) {
+      std::cerr << "Scene 10 shows a mesh file given with -m." << std::endl;
+      return scene;
+    }
+    Stopwatch stopwatch;
+    stopwatch.start();
+    const auto mesh = MeshLoader::load(meshFile, white, threadCount);
+    if (!mesh) return scene;
+    stopwatch.stop();
+    std::cout << "Loaded " << mesh->getTriangleCount() << " triangles from " << meshFile << " in "
+              << stopwatch.getElapsedSeconds() << "s" << std::endl;
+
+    AABB box;
+    mesh->computeBoundingBox(0, 1, box);
+    const Vector3 extent = box.getMax() - box.getMin();
+    const Real scale = 330 / std::fmax(extent.x, std::fmax(extent.y, extent.z));
+    const Point3 base(0.5 * (box.getMin().x + box.getMax().x), box.getMin().y, 0.5 * (box.getMin().z + box.getMax().z));
+    scene.add(std::make_shared<Instance>(mesh, Transform::translation(Vector3(278, 0, 278)) *
+                                                   Transform::scaling(scale) *
+                                                   Transform::translation(Point3(0, 0, 0) - base)));
+    return scene;
+  }
+
+  // 160 white spheres scattered in a 165 unit cube.
+  Scene sphereCluster() {
+    Scene spheres;
+    auto white = std::make_shared<Lambertian>(Color(.73, .73, .73));
+    int sphereCount = 160;
+    for (int j = 0; j < sphereCount; j++) {
+      spheres.add(std::make_shared<Sphere>(Random::pointRange(0, 165), 10, white));
+    }
+    return spheres;
+  }
+
+  // Accelerator wraps the ground and the sphere cluster; it is a parameter so benchmarks can swap it.
+  template <typename Accelerator = LinearBVH>
+  Scene finalScene() {
+    Scene scene;
+
+    // Ground and spheres are drawn before any accelerator is built so the geometry does not depend on its type.
+    Scene ground = boxGround();
+    Scene spheres = sphereCluster();
 
-    scene.add(std::make_shared<BVHNode>(ground, 0, 1));
+    scene.add(std::make_shared<Accelerator>(ground, 0, 1));
 
     // Light
     auto lightMat = std::make_shared<DiffuseLight>(Color(7, 7, 7));
@@ -291,16 +354,8 @@ namespace Scenes {
     auto perlinTexture = std::make_shared<PerlinTexture>(0.1);
     scene.add(std::make_shared<Sphere>(Point3(220, 280, 300), 80, std::make_shared<Lambertian>(perlinTexture)));
 
-    // Spheres
-    Scene spheres;
-    auto white = std::make_shared<Lambertian>(Color(.73, .73, .73));
-    int sphereCount = 160;
-    for (int j = 0; j < sphereCount; j++) {
-      spheres.add(std::make_shared<Sphere>(Random::pointRange(0, 165), 10, white));
-    }
-
-    scene.add(std::make_shared<Translate>(std::make_shared<RotateY>(std::make_shared<BVHNode>(spheres, 0.0, 1.0), 15),
-                                          Vector3(-100, 270, 395)));
+    scene.add(std::make_shared<Translate>(
+        std::make_shared<RotateY>(std::make_shared<Accelerator>(spheres, 0.0, 1.0), 15), Vector3(-100, 270, 395)));
 
     return scene;
   }
@@ -394,6 +449,17 @@ namespace Scenes {
         config.verticalFOV = 40.0;
         break;
 
+      case 10:
+        scene = Scenes::cornellMesh(config.meshFile, config.threadCount);
+        config.lookFrom = Point3(278, 278, -800);
+        config.lookAt = Point3(278, 278, 0);
+        config.verticalFOV = 40.0;
+        config.aspectRatio = 1.0;
+        config.imageWidth = 600;
+        config.imageHeight = static_cast<int>(config.imageWidth / config.aspectRatio);
+        config.background = Color(0, 0, 0);
+        break;
+
       default:
         scene = Scenes::cornellBox();
         config.lookFrom = Point3(278, 278, -800);
@@ -0,0 +1,36 @@
+#ifndef SERIALIZATION_HPP
+#define SERIALIZATION_HPP
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <type_traits>
+
+// Raw binary I/O of plain values for checkpoints. Files are only meant to be read back on the same platform.
+namespace Serialization {
+  template <typename T>
+  void write(std::ostream& out, const T& value) {
+    static_assert(std::is_trivially_copyable<T>::value, "only plain values can be written");
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  template <typename T>
+  bool read(std::istream& in, T& value) {
+    static_assert(std::is_trivially_copyable<T>::value, "only plain values can be read");
+    return bool(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+  }
+
+  inline void writeString(std::ostream& out, const std::string& string) {
+    write<uint32_t>(out, string.size());
+    out.write(string.data(), string.size());
+  }
+
+  inline bool readString(std::istream& in, std::string& string) {
+    uint32_t size;
+    if (!read(in, size)) return false;
+    string.resize(size);
+    return bool(in.read(&string[0], size));
+  }
+}
+
+#endif
@@ -15,14 +15,16 @@ class Stopwatch {
 
  public:
   Stopwatch() : samples(0), totalTime(0) {}
-  void start() { startPoint = std::chrono::high_resolution_clock::now(); }
-  void stop() { stopPoint = std::chrono::high_resolution_clock::now(); }
+  void start() { startPoint = std::chrono::steady_clock::now(); }
+  void stop() { stopPoint = std::chrono::steady_clock::now(); }
   int printTime() const {
     const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(stopPoint - startPoint);
     std::cout << seconds.count() << "s" << std::endl;
 		return seconds.count();
   }
 
+  double getElapsedSeconds() const { return std::chrono::duration<double>(stopPoint - startPoint).count(); }
+
   void collectSample() {
     stop();
     totalTime += std::chrono::duration_cast<std::chrono::milliseconds>(stopPoint - startPoint);
@@ -5,14 +5,16 @@
 #include "../Math/Ray.hpp"
 #include "../Math/Vector3.hpp"
 
+class GeometricalObject;
 class Material;
 struct SurfaceInteraction {
   Point3 point;
   Vector3 normal;
   UV uv;
-  double t;
+  Real t;
   bool frontFace;
-  std::shared_ptr<Material> materialPtr;
+  Material* materialPtr = nullptr;  // owned by the object that was hit
+  const GeometricalObject* objectPtr = nullptr;  // the scene's top level object that was hit, set by Scene
 
   SurfaceInteraction() = default;
 
@@ -23,7 +25,8 @@ struct SurfaceInteraction {
       uv(other.uv),
       t(other.t),
       frontFace(other.frontFace),
-      materialPtr(other.materialPtr) {}
+      materialPtr(other.materialPtr),
+      objectPtr(other.objectPtr) {}
 
   // Move constructor
   SurfaceInteraction(SurfaceInteraction&& other) noexcept :
@@ -32,7 +35,8 @@ struct SurfaceInteraction {
       uv(std::move(other.uv)),
       t(std::exchange(other.t, 0)),
       frontFace(std::exchange(other.frontFace, 0)),
-      materialPtr(std::move(other.materialPtr)) {}
+      materialPtr(std::move(other.materialPtr)),
+      objectPtr(other.objectPtr) {}
 
   // Copy assignment
   SurfaceInteraction& operator=(const SurfaceInteraction& other) {
@@ -42,6 +46,7 @@ struct SurfaceInteraction {
     t = other.t;
     frontFace = other.frontFace;
     materialPtr = other.materialPtr;
+    objectPtr = other.objectPtr;
     return *this;
   }
 
@@ -53,6 +58,7 @@ struct SurfaceInteraction {
     t = other.t;
     frontFace = other.frontFace;
     materialPtr = other.materialPtr;
+    objectPtr = other.objectPtr;
     return *this;
   }
 
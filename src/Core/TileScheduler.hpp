@@ -0,0 +1,84 @@
+#ifndef TILE_SCHEDULER_HPP
+#define TILE_SCHEDULER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Rectangular image region [x0, x1) x [y0, y1) in image space (y grows upwards as in the integrators).
+struct Tile {
+  size_t x0, y0;
+  size_t x1, y1;
+
+  Tile(size_t x0, size_t y0, size_t x1, size_t y1) : x0(x0), y0(y0), x1(x1), y1(y1) {}
+};
+
+// Distributes image tiles over a pool of worker threads.
+// Every worker starts on its own contiguous run of tiles and steals from the others once it runs dry, so uneven
+// tiles (e.g. the light or glass objects) do not leave cores idle at the end of a frame.
+class TileScheduler {
+ private:
+  // A run of tiles owned by one worker; next is shared with thieves.
+  struct WorkQueue {
+    std::atomic<size_t> next;
+    size_t end;
+    WorkQueue() : next(0), end(0) {}
+  };
+
+  std::vector<Tile> tiles;
+  unsigned threadCount;
+
+  bool popTile(WorkQueue& queue, size_t& tileIndex) const {
+    tileIndex = queue.next.fetch_add(1, std::memory_order_relaxed);
+    return tileIndex < queue.end;
+  }
+
+ public:
+  TileScheduler(size_t imageHeight, size_t imageWidth, unsigned threadCount, size_t tileSize = 16) :
+      threadCount(std::max(threadCount, 1u)) {
+    for (size_t y = 0; y < imageHeight; y += tileSize)
+      for (size_t x = 0; x < imageWidth; x += tileSize)
+        tiles.emplace_back(x, y, std::min(x + tileSize, imageWidth), std::min(y + tileSize, imageHeight));
+  }
+
+  size_t getTileCount() const { return tiles.size(); }
+  unsigned getThreadCount() const { return threadCount; }
+
+  // Calls tileFunction(tile, threadIndex) once for every tile. The calling thread takes part as worker 0.
+  template <typename TileFunction>
+  void run(TileFunction tileFunction) const {
+    const unsigned workerCount = std::min<size_t>(threadCount, std::max<size_t>(tiles.size(), 1));
+    std::unique_ptr<WorkQueue[]> queues(new WorkQueue[workerCount]);
+    for (unsigned i = 0; i < workerCount; i++) {
+      queues[i].next = tiles.size() * i / workerCount;
+      queues[i].end = tiles.size() * (i + 1) / workerCount;
+    }
+
+    std::atomic<size_t> tilesDone(0);
+    std::mutex outputMutex;
+
+    auto worker = [&](unsigned threadIndex) {
+      size_t tileIndex;
+      for (unsigned offset = 0; offset < workerCount; offset++) {
+        WorkQueue& queue = queues[(threadIndex + offset) % workerCount];
+        while (popTile(queue, tileIndex)) {
+          tileFunction(tiles[tileIndex], threadIndex);
+          const size_t done = tilesDone.fetch_add(1) + 1;
+          std::lock_guard<std::mutex> lock(outputMutex);
+          std::cout << "\rTiles remaining: " << tiles.size() - done << "  " << std::flush;
+        }
+      }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < workerCount; i++) threads.emplace_back(worker, i);
+    worker(0);
+    for (auto& thread : threads) thread.join();
+  }
+};
+
+#endif
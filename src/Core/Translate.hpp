@@ -10,7 +10,7 @@ class Translate : public GeometricalObject {
 
  public:
   Translate(std::shared_ptr<GeoObject> object, const Vector3& offset) : object(object), offset(offset) {}
-  virtual bool intersect(const Ray& ray, double tMin, double tMax, SInteraction& interaction) const override {
+  virtual bool intersect(const Ray& ray, Real tMin, Real tMax, SInteraction& interaction) const override {
     const Ray movedRay(ray.origin - offset, ray.direction, ray.getTime());
     if (!object->intersect(movedRay, tMin, tMax, interaction)) return false;
 
@@ -18,11 +18,41 @@ class Translate : public GeometricalObject {
     interaction.setFaceNormal(movedRay, interaction.normal);
     return true;
   }
-  virtual bool computeBoundingBox(double t0, double t1, AABB& outputBox) const override {
+  virtual bool occluded(const Ray& ray, Real tMin, Real tMax) const override {
+    return object->occluded(Ray(ray.origin - offset, ray.direction, ray.getTime()), tMin, tMax);
+  }
+  virtual int intersectPacket(const RayPacket& packet, int laneMask, Real tMin, Real tMax[],
+                              SInteraction interactions[]) const override {
+    const RayPacket movedPacket = movePacket(packet, laneMask);
+    const int hitMask = object->intersectPacket(movedPacket, laneMask, tMin, tMax, interactions);
+    for (int lane = 0; lane < RayPacket::size; lane++) {
+      if (!RayPacket::isSet(hitMask, lane)) continue;
+      interactions[lane].point += offset;
+      interactions[lane].setFaceNormal(movedPacket.rays[lane], interactions[lane].normal);
+    }
+    return hitMask;
+  }
+  virtual int occludedPacket(const RayPacket& packet, int laneMask, Real tMin, const Real tMax[]) const override {
+    return object->occludedPacket(movePacket(packet, laneMask), laneMask, tMin, tMax);
+  }
+  virtual bool computeBoundingBox(Real t0, Real t1, AABB& outputBox) const override {
     if (!object->computeBoundingBox(t0, t1, outputBox)) return false;
     outputBox = AABB(outputBox.getMin() + offset, outputBox.getMax() + offset);
     return true;
   }
+  void collectMaterials(std::vector<std::shared_ptr<Material>>& materials) const override {
+    object->collectMaterials(materials);
+  }
+
+  RayPacket movePacket(const RayPacket& packet, int laneMask) const {
+    RayPacket movedPacket;
+    for (int lane = 0; lane < RayPacket::size; lane++) {
+      if (!RayPacket::isSet(laneMask, lane)) continue;
+      const Ray& ray = packet.rays[lane];
+      movedPacket.set(lane, Ray(ray.origin - offset, ray.direction, ray.getTime()));
+    }
+    return movedPacket;
+  }
 };
 
 #endif
\ No newline at end of file
@@ -5,6 +5,8 @@
 #include "../Integrators/BDPIntegrator.hpp"
 #include "../Integrators/MLTIntegrator.hpp"
 #include "../Integrators/PathIntegrator.hpp"
+#include "../Integrators/ProgressiveRenderer.hpp"
+#include "../Integrators/WavefrontIntegrator.hpp"
 #include "../Materials/Dielectric.hpp"
 #include "../Materials/Lambertian.hpp"
 #include "../Materials/Metal.hpp"
@@ -25,6 +27,7 @@ int main(int argc, char const* argv[]) {
 
   // Config
   Config config;
+  config.meshFile = argParser.meshFile;  // read while the scene is built
   Scene scene = Scenes::selectScene(argParser.sceneSelection, config);
 
   argParser.setConfig(config);
@@ -42,6 +45,8 @@ int main(int argc, char const* argv[]) {
       return std::make_shared<BDPTIntegrator>(config, scene, camera);
     else if (type == IntegratorType::Metropolis)
       return std::make_shared<MLTIntegrator>(config, scene, camera);
+    else if (type == IntegratorType::Wavefront)
+      return std::make_shared<WavefrontIntegrator>(config, scene, camera);
     else
       return std::make_shared<BDPTIntegrator>(config, scene, camera);
   };
@@ -53,7 +58,11 @@ int main(int argc, char const* argv[]) {
 
   // Rendering
   std::shared_ptr<Integrator> integrator = selectIntegrator(argParser.integratorType);
-  integrator->render(image);
+  ProgressiveRenderer renderer(*integrator, config);
+  if (config.resumeFile.length() > 0 && !renderer.resume(image, config.resumeFile)) return 1;
+  renderer.render(image);
+  const int samplesPerPixel = config.samplesPerPixel * renderer.getPassesDone();
+  image.imageInfo.samplesPerPixel = samplesPerPixel;
 
   std::cout << std::endl << "Done." << std::endl;
   stopwatch.stop();
@@ -63,7 +72,9 @@ int main(int argc, char const* argv[]) {
   std::cout << std::endl << "Writing image to file." << std::endl;
   stopwatch.start();
 
-  image.writeToFile(argParser.fileName, config.samplesPerPixel);
+  image.normalize(samplesPerPixel);
+  if (config.toneMap) image.toneMap();
+  image.writeToFile(argParser.fileName, config.outputFormat);
 
   stopwatch.stop();
   stopwatch.printTime();
@@ -11,28 +11,70 @@
 class Rectangle : public GeometricalObject {
  protected:
   std::shared_ptr<Material> material;
-  std::vector<double> corners;
-  double k;
+  std::vector<Real> corners;
+  Real k;
 
   Rectangle() {}
-  Rectangle(std::initializer_list<double> corners, double k, std::shared_ptr<Material> material) :
+  Rectangle(std::initializer_list<Real> corners, Real k, std::shared_ptr<Material> material) :
+      material(material),
       corners(corners),
-      k(k),
-      material(material) {}
+      k(k) {}
 
-  void setInteraction(const Ray& ray, SInteraction& interaction, const Vector3 outwardNormal, double x, double y,
-                      double t) const {
+  void setInteraction(const Ray& ray, SInteraction& interaction, const Vector3 outwardNormal, Real x, Real y,
+                      Real t) const {
     interaction.uv = UV((x - corners[0]) / (corners[1] - corners[0]), (y - corners[2]) / (corners[3] - corners[2]));
     interaction.t = t;
     interaction.setFaceNormal(ray, outwardNormal);
-    interaction.materialPtr = material;
+    interaction.materialPtr = material.get();
     interaction.point = ray.at(t);
   }
 
-  virtual bool computeBoundingBox(double t0, double t1, AABB& outputBox) const override {
-    double padding = 0.0001;
-    outputBox = AABB(Point3(corners[0], corners[2], k - padding), Point3(corners[1], corners[3], k + padding));
-    return true;
+  // Box padded along the rectangle's normal axis, given as (axis of first corner pair, axis of second, normal axis).
+  AABB paddedBox(int axisA, int axisB, int normalAxis) const {
+    const Real padding = 0.0001;
+    Point3 min, max;
+    min[axisA] = corners[0];
+    max[axisA] = corners[1];
+    min[axisB] = corners[2];
+    max[axisB] = corners[3];
+    min[normalAxis] = k - padding;
+    max[normalAxis] = k + padding;
+    return AABB(min, max);
+  }
+
+  // Plane test of every packet lane, written without branches so the loop vectorizes. Fills the hit distance and the
+  // in-plane coordinates per lane and returns the mask of lanes that hit.
+  int hitPlanePacket(const RayPacket& packet, int laneMask, Real tMin, const Real tMax[], int axisA, int axisB,
+                     int normalAxis, Real t[], Real a[], Real b[]) const {
+    int hitMask = 0;
+    for (int lane = 0; lane < RayPacket::size; lane++) {
+      t[lane] = (k - packet.origin[normalAxis][lane]) / packet.direction[normalAxis][lane];
+      a[lane] = packet.origin[axisA][lane] + t[lane] * packet.direction[axisA][lane];
+      b[lane] = packet.origin[axisB][lane] + t[lane] * packet.direction[axisB][lane];
+      const bool hit = t[lane] > tMin && t[lane] < tMax[lane] &&
+                       !(a[lane] < corners[0] || a[lane] > corners[1] || b[lane] < corners[2] || b[lane] > corners[3]);
+      hitMask |= hit << lane;
+    }
+    return hitMask & laneMask;
+  }
+
+  int intersectPlanePacket(const RayPacket& packet, int laneMask, Real tMin, Real tMax[],
+                           SInteraction interactions[], int axisA, int axisB, int normalAxis,
+                           const Vector3& outwardNormal) const {
+    Real t[RayPacket::size], a[RayPacket::size], b[RayPacket::size];
+    const int hitMask = hitPlanePacket(packet, laneMask, tMin, tMax, axisA, axisB, normalAxis, t, a, b);
+    for (int lane = 0; lane < RayPacket::size; lane++) {
+      if (!RayPacket::isSet(hitMask, lane)) continue;
+      setInteraction(packet.rays[lane], interactions[lane], outwardNormal, a[lane], b[lane], t[lane]);
+      tMax[lane] = t[lane];
+    }
+    return hitMask;
+  }
+
+  int occludedPlanePacket(const RayPacket& packet, int laneMask, Real tMin, const Real tMax[], int axisA,
+                          int axisB, int normalAxis) const {
+    Real t[RayPacket::size], a[RayPacket::size], b[RayPacket::size];
+    return hitPlanePacket(packet, laneMask, tMin, tMax, axisA, axisB, normalAxis, t, a, b);
   }
 
   // Returns a pointer to the rectangle material
@@ -44,38 +86,61 @@ class RectangleXY : public Rectangle {
 
  public:
   RectangleXY() : Rectangle() {}
-  RectangleXY(std::initializer_list<double> corners, double k, std::shared_ptr<Material> material) :
+  RectangleXY(std::initializer_list<Real> corners, Real k, std::shared_ptr<Material> material) :
       Rectangle(corners, k, material) {}
-  RectangleXY(std::initializer_list<double> corners, double k, std::shared_ptr<Material> material, int side) :
+  RectangleXY(std::initializer_list<Real> corners, Real k, std::shared_ptr<Material> material, int side) :
       Rectangle(corners, k, material) {
     normal *= side;
   }
 
-  virtual bool intersect(const Ray& ray, double tMin, double tMax, SInteraction& interaction) const override {
-    const double t = (k - ray.origin.z) / ray.direction.z;
+  virtual bool intersect(const Ray& ray, Real tMin, Real tMax, SInteraction& interaction) const override {
+    const Real t = (k - ray.origin.z) / ray.direction.z;
     if (!(t > tMin) || !(t < tMax)) return false;
 
-    const double x = ray.origin.x + t * ray.direction.x;
-    const double y = ray.origin.y + t * ray.direction.y;
+    const Real x = ray.origin.x + t * ray.direction.x;
+    const Real y = ray.origin.y + t * ray.direction.y;
     if (x < corners[0] || x > corners[1] || y < corners[2] || y > corners[3]) return false;
 
     setInteraction(ray, interaction, Vector3(0, 0, 1), x, y, t);
     return true;
   }
 
+  virtual bool occluded(const Ray& ray, Real tMin, Real tMax) const override {
+    const Real t = (k - ray.origin.z) / ray.direction.z;
+    if (!(t > tMin) || !(t < tMax)) return false;
+
+    const Real x = ray.origin.x + t * ray.direction.x;
+    const Real y = ray.origin.y + t * ray.direction.y;
+    return !(x < corners[0] || x > corners[1] || y < corners[2] || y > corners[3]);
+  }
+
+  virtual bool computeBoundingBox(Real t0, Real t1, AABB& outputBox) const override {
+    outputBox = paddedBox(0, 1, 2);
+    return true;
+  }
+
+  virtual int intersectPacket(const RayPacket& packet, int laneMask, Real tMin, Real tMax[],
+                              SInteraction interactions[]) const override {
+    return intersectPlanePacket(packet, laneMask, tMin, tMax, interactions, 0, 1, 2, Vector3(0, 0, 1));
+  }
+
+  virtual int occludedPacket(const RayPacket& packet, int laneMask, Real tMin, const Real tMax[]) const override {
+    return occludedPlanePacket(packet, laneMask, tMin, tMax, 0, 1, 2);
+  }
+
   // Returns a random point on this light rectangle.
-  Point3 samplePoint() const override {
-    return Point3(Random::range(corners[0], corners[1]), Random::range(corners[2], corners[3]), k);
+  Point3 samplePoint(RNG& rng) const override {
+    return Point3(Random::range(rng, corners[0], corners[1]), Random::range(rng, corners[2], corners[3]), k);
   }
 
-  Ray sampleDirection() const override {
-    Point3 origin = samplePoint();
+  Ray sampleDirection(RNG& rng) const override {
+    Point3 origin = samplePoint(rng);
     ONB orthonormalBasis(normal);
-    Vector3 direction = orthonormalBasis.local(Random::cosineDirection());
+    Vector3 direction = orthonormalBasis.local(Random::cosineDirection(rng));
     return Ray(origin, direction);
   }
 
-  double getArea() const override { return std::abs(corners[0] - corners[1]) * std::abs(corners[2] - corners[3]); }
+  Real getArea() const override { return std::abs(corners[0] - corners[1]) * std::abs(corners[2] - corners[3]); }
 };
 
 class RectangleXZ : public Rectangle {
@@ -83,51 +148,74 @@ class RectangleXZ : public Rectangle {
 
  public:
   RectangleXZ() : Rectangle() {}
-  RectangleXZ(std::initializer_list<double> corners, double k, std::shared_ptr<Material> material) :
+  RectangleXZ(std::initializer_list<Real> corners, Real k, std::shared_ptr<Material> material) :
       Rectangle(corners, k, material) {}
-  RectangleXZ(std::initializer_list<double> corners, double k, std::shared_ptr<Material> material, int side) :
+  RectangleXZ(std::initializer_list<Real> corners, Real k, std::shared_ptr<Material> material, int side) :
       Rectangle(corners, k, material) {
     normal *= side;
   }
 
-  virtual bool intersect(const Ray& ray, double tMin, double tMax, SInteraction& interaction) const override {
-    const double t = (k - ray.origin.y) / ray.direction.y;
+  virtual bool intersect(const Ray& ray, Real tMin, Real tMax, SInteraction& interaction) const override {
+    const Real t = (k - ray.origin.y) / ray.direction.y;
     if (!(t > tMin) || !(t < tMax)) return false;
 
-    const double x = ray.origin.x + t * ray.direction.x;
-    const double z = ray.origin.z + t * ray.direction.z;
+    const Real x = ray.origin.x + t * ray.direction.x;
+    const Real z = ray.origin.z + t * ray.direction.z;
     if (x < corners[0] || x > corners[1] || z < corners[2] || z > corners[3]) return false;
 
     setInteraction(ray, interaction, Vector3(0, 1, 0), x, z, t);
     return true;
   }
 
+  virtual bool occluded(const Ray& ray, Real tMin, Real tMax) const override {
+    const Real t = (k - ray.origin.y) / ray.direction.y;
+    if (!(t > tMin) || !(t < tMax)) return false;
+
+    const Real x = ray.origin.x + t * ray.direction.x;
+    const Real z = ray.origin.z + t * ray.direction.z;
+    return !(x < corners[0] || x > corners[1] || z < corners[2] || z > corners[3]);
+  }
+
+  virtual bool computeBoundingBox(Real t0, Real t1, AABB& outputBox) const override {
+    outputBox = paddedBox(0, 2, 1);
+    return true;
+  }
+
+  virtual int intersectPacket(const RayPacket& packet, int laneMask, Real tMin, Real tMax[],
+                              SInteraction interactions[]) const override {
+    return intersectPlanePacket(packet, laneMask, tMin, tMax, interactions, 0, 2, 1, Vector3(0, 1, 0));
+  }
+
+  virtual int occludedPacket(const RayPacket& packet, int laneMask, Real tMin, const Real tMax[]) const override {
+    return occludedPlanePacket(packet, laneMask, tMin, tMax, 0, 2, 1);
+  }
+
   // Returns a random point on this light rectangle.
-  Point3 samplePoint() const override {
-    return Point3(Random::range(corners[0], corners[1]), k, Random::range(corners[2], corners[3]));
+  Point3 samplePoint(RNG& rng) const override {
+    return Point3(Random::range(rng, corners[0], corners[1]), k, Random::range(rng, corners[2], corners[3]));
   }
 
-  Point3 samplePoint(double random1, double random2) const override {
+  Point3 samplePoint(Real random1, Real random2) const override {
     auto x = Random::mapInterval(random1, corners[0], corners[1]);
     auto z = Random::mapInterval(random2, corners[2], corners[3]);
     return Point3(x, k, z);
   }
 
-  Ray sampleDirection() const override {
-    Point3 origin = samplePoint();
+  Ray sampleDirection(RNG& rng) const override {
+    Point3 origin = samplePoint(rng);
     ONB orthonormalBasis(normal);
-    Vector3 direction = orthonormalBasis.local(Random::cosineDirection());
+    Vector3 direction = orthonormalBasis.local(Random::cosineDirection(rng));
     return Ray(origin, direction);
   }
 
-  Ray sampleDirection(double random1, double random2, double random3, double random4) const override {
+  Ray sampleDirection(Real random1, Real random2, Real random3, Real random4) const override {
     Point3 origin = samplePoint(random1, random2);
     ONB orthonormalBasis(normal);
     Vector3 direction = orthonormalBasis.local(Random::cosineDirection(random3, random4));
     return Ray(origin, direction);
   }
 
-  double getArea() const override { return std::abs(corners[0] - corners[1]) * std::abs(corners[2] - corners[3]); }
+  Real getArea() const override { return std::abs(corners[0] - corners[1]) * std::abs(corners[2] - corners[3]); }
 };
 
 class RectangleYZ : public Rectangle {
@@ -135,50 +223,73 @@ class RectangleYZ : public Rectangle {
 
  public:
   RectangleYZ() : Rectangle() {}
-  RectangleYZ(std::initializer_list<double> corners, double k, std::shared_ptr<Material> material) :
+  RectangleYZ(std::initializer_list<Real> corners, Real k, std::shared_ptr<Material> material) :
       Rectangle(corners, k, material) {}
-  RectangleYZ(std::initializer_list<double> corners, double k, std::shared_ptr<Material> material, int side) :
+  RectangleYZ(std::initializer_list<Real> corners, Real k, std::shared_ptr<Material> material, int side) :
       Rectangle(corners, k, material) {
     normal *= side;
   }
 
-  virtual bool intersect(const Ray& ray, double tMin, double tMax, SInteraction& interaction) const override {
-    const double t = (k - ray.origin.x) / ray.direction.x;
+  virtual bool intersect(const Ray& ray, Real tMin, Real tMax, SInteraction& interaction) const override {
+    const Real t = (k - ray.origin.x) / ray.direction.x;
     if (!(t > tMin) || !(t < tMax)) return false;
 
-    const double y = ray.origin.y + t * ray.direction.y;
-    const double z = ray.origin.z + t * ray.direction.z;
+    const Real y = ray.origin.y + t * ray.direction.y;
+    const Real z = ray.origin.z + t * ray.direction.z;
     if (y < corners[0] || y > corners[1] || z < corners[2] || z > corners[3]) return false;
 
     setInteraction(ray, interaction, Vector3(1, 0, 0), y, z, t);
     return true;
   }
 
+  virtual bool occluded(const Ray& ray, Real tMin, Real tMax) const override {
+    const Real t = (k - ray.origin.x) / ray.direction.x;
+    if (!(t > tMin) || !(t < tMax)) return false;
+
+    const Real y = ray.origin.y + t * ray.direction.y;
+    const Real z = ray.origin.z + t * ray.direction.z;
+    return !(y < corners[0] || y > corners[1] || z < corners[2] || z > corners[3]);
+  }
+
+  virtual bool computeBoundingBox(Real t0, Real t1, AABB& outputBox) const override {
+    outputBox = paddedBox(1, 2, 0);
+    return true;
+  }
+
+  virtual int intersectPacket(const RayPacket& packet, int laneMask, Real tMin, Real tMax[],
+                              SInteraction interactions[]) const override {
+    return intersectPlanePacket(packet, laneMask, tMin, tMax, interactions, 1, 2, 0, Vector3(1, 0, 0));
+  }
+
+  virtual int occludedPacket(const RayPacket& packet, int laneMask, Real tMin, const Real tMax[]) const override {
+    return occludedPlanePacket(packet, laneMask, tMin, tMax, 1, 2, 0);
+  }
+
   // Returns a random point on this light rectangle.
-  Point3 samplePoint() const override {
-    return Point3(k, Random::range(corners[0], corners[1]), Random::range(corners[2], corners[3]));
+  Point3 samplePoint(RNG& rng) const override {
+    return Point3(k, Random::range(rng, corners[0], corners[1]), Random::range(rng, corners[2], corners[3]));
   }
 
-  Point3 samplePoint(double random1, double random2) const override {
+  Point3 samplePoint(Real random1, Real random2) const override {
     auto y = Random::mapInterval(random1, corners[0], corners[1]);
     auto z = Random::mapInterval(random2, corners[2], corners[3]);
     return Point3(k, y, z);
   }
 
-  Ray sampleDirection() const override {
-    Point3 origin = samplePoint();
+  Ray sampleDirection(RNG& rng) const override {
+    Point3 origin = samplePoint(rng);
     ONB orthonormalBasis(normal);
-    Vector3 direction = orthonormalBasis.local(Random::cosineDirection());
+    Vector3 direction = orthonormalBasis.local(Random::cosineDirection(rng));
     return Ray(origin, direction);
   }
 
-  Ray sampleDirection(double random1, double random2, double random3, double random4) const override {
+  Ray sampleDirection(Real random1, Real random2, Real random3, Real random4) const override {
     Point3 origin = samplePoint(random1, random2);
     ONB orthonormalBasis(normal);
     Vector3 direction = orthonormalBasis.local(Random::cosineDirection(random3, random4));
     return Ray(origin, direction);
   }
 
-  double getArea() const override { return std::abs(corners[0] - corners[1]) * std::abs(corners[2] - corners[3]); }
+  Real getArea() const override { return std::abs(corners[0] - corners[1]) * std::abs(corners[2] - corners[3]); }
 };
 #endif
\ No newline at end of file
@@ -1,41 +1,112 @@
 #ifndef BOX_HPP
 #define BOX_HPP
 
-#include "../Core/Scene.hpp"
-#include "../GeoObjects/AxisAlignedRectangle.hpp"
+#include <cmath>
+#include <utility>
 
+#include "../Math/Math.hpp"
+#include "GeometricalObject.hpp"
+
+// Axis aligned box intersected with one slab test. The face hit, its normal and its UV follow from the slab that
+// bounds the hit distance; UVs match those of the six rectangles the box used to be made of.
 class Box : public GeometricalObject {
  private:
   Point3 min;
   Point3 max;
-  Scene sides;
   std::shared_ptr<Material> material;
 
+  // On a hit, t is the entry distance, or the exit distance for rays starting inside, and face is the axis of the
+  // plane hit, plus 3 on the max side. Rays parallel to a slab are inside it or miss through an infinite distance.
+  // The plane distances are divided out as the rectangles did, not multiplied by an inverse direction, so hits match
+  // those of the six rectangles to the bit and renders stay the same.
+  bool hitSlabs(const Ray& ray, Real tMin, Real tMax, Real& t, int& face) const {
+    Real tEntry = -Math::realInfinity, tExit = Math::realInfinity;
+    int entryFace = 0, exitFace = 0;
+    for (int a = 0; a < 3; a++) {
+      Real tNear = (min[a] - ray.origin[a]) / ray.direction[a];
+      Real tFar = (max[a] - ray.origin[a]) / ray.direction[a];
+      int nearFace = a, farFace = a + 3;
+      if (std::signbit(ray.direction[a])) {
+        std::swap(tNear, tFar);
+        std::swap(nearFace, farFace);
+      }
+      if (tNear > tEntry) {
+        tEntry = tNear;
+        entryFace = nearFace;
+      }
+      if (tFar < tExit) {
+        tExit = tFar;
+        exitFace = farFace;
+      }
+    }
+    if (tEntry > tExit) return false;
+    t = tEntry > tMin ? tEntry : tExit;
+    face = tEntry > tMin ? entryFace : exitFace;
+    return t > tMin && t < tMax;
+  }
+
+  void setInteraction(const Ray& ray, Real t, int face, SInteraction& interaction) const {
+    const int axis = face % 3;
+    // In-plane axes in the order of the rectangles: (y, z) for x faces, (x, z) for y faces, (x, y) for z faces.
+    const int axisA = axis == 0 ? 1 : 0;
+    const int axisB = axis == 2 ? 1 : 2;
+    interaction.point = ray.at(t);
+    interaction.uv = UV((interaction.point[axisA] - min[axisA]) / (max[axisA] - min[axisA]),
+                        (interaction.point[axisB] - min[axisB]) / (max[axisB] - min[axisB]));
+    interaction.t = t;
+    Vector3 outwardNormal(0, 0, 0);
+    outwardNormal[axis] = face < 3 ? -1 : 1;
+    interaction.setFaceNormal(ray, outwardNormal);
+    interaction.materialPtr = material.get();
+  }
+
  public:
   Box() {}
-  Box(const Point3& min, const Point3& max, std::shared_ptr<Material> material) : min(min), max(max) {
-    const RectangleXY sideA({min.x, max.x, min.y, max.y}, max.z, material);
-    const RectangleXY sideB({min.x, max.x, min.y, max.y}, min.z, material);
-    const RectangleXZ sideC({min.x, max.x, min.z, max.z}, max.y, material);
-    const RectangleXZ sideD({min.x, max.x, min.z, max.z}, min.y, material);
-    const RectangleYZ sideE({min.y, max.y, min.z, max.z}, max.x, material);
-    const RectangleYZ sideF({min.y, max.y, min.z, max.z}, min.x, material);
-
-    sides.add(std::make_shared<RectangleXY>(sideA));
-    sides.add(std::make_shared<RectangleXY>(sideB));
-    sides.add(std::make_shared<RectangleXZ>(sideC));
-    sides.add(std::make_shared<RectangleXZ>(sideD));
-    sides.add(std::make_shared<RectangleYZ>(sideE));
-    sides.add(std::make_shared<RectangleYZ>(sideF));
-
-    this->material = material;
+  Box(const Point3& min, const Point3& max, std::shared_ptr<Material> material) :
+      min(min),
+      max(max),
+      material(material) {}
+
+  virtual bool intersect(const Ray& ray, Real tMin, Real tMax, SInteraction& interaction) const override {
+    Real t;
+    int face;
+    if (!hitSlabs(ray, tMin, tMax, t, face)) return false;
+    setInteraction(ray, t, face, interaction);
+    return true;
+  }
+
+  virtual bool occluded(const Ray& ray, Real tMin, Real tMax) const override {
+    Real t;
+    int face;
+    return hitSlabs(ray, tMin, tMax, t, face);
+  }
+
+  virtual int intersectPacket(const RayPacket& packet, int laneMask, Real tMin, Real tMax[],
+                              SInteraction interactions[]) const override {
+    int hitMask = 0;
+    for (int lane = 0; lane < RayPacket::size; lane++) {
+      Real t;
+      int face;
+      if (!RayPacket::isSet(laneMask, lane) || !hitSlabs(packet.rays[lane], tMin, tMax[lane], t, face)) continue;
+      setInteraction(packet.rays[lane], t, face, interactions[lane]);
+      tMax[lane] = t;
+      hitMask |= 1 << lane;
+    }
+    return hitMask;
   }
 
-  virtual bool intersect(const Ray& ray, double tMin, double tMax, SInteraction& interaction) const override {
-    return sides.intersect(ray, tMin, tMax, interaction);
+  virtual int occludedPacket(const RayPacket& packet, int laneMask, Real tMin, const Real tMax[]) const override {
+    int blockedMask = 0;
+    for (int lane = 0; lane < RayPacket::size; lane++) {
+      Real t;
+      int face;
+      if (RayPacket::isSet(laneMask, lane) && hitSlabs(packet.rays[lane], tMin, tMax[lane], t, face))
+        blockedMask |= 1 << lane;
+    }
+    return blockedMask;
   }
 
-  virtual bool computeBoundingBox(double t0, double t1, AABB& outputBox) const override {
+  virtual bool computeBoundingBox(Real t0, Real t1, AABB& outputBox) const override {
     outputBox = AABB(min, max);
     return true;
   }
@@ -43,4 +114,4 @@ class Box : public GeometricalObject {
   std::shared_ptr<Material> getMaterial() const override { return material; }
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -10,54 +10,75 @@ class ConstantMedium : public GeometricalObject {
  private:
   std::shared_ptr<GeometricalObject> shape;
   std::shared_ptr<Material> phaseFunction;
-  double negInvDensity;
+  Real negInvDensity;
 
- public:
-  ConstantMedium(std::shared_ptr<GeoObject> shape, double density, std::shared_ptr<Texture> albedo) :
-      shape(shape),
-      negInvDensity(-1 / density),
-      phaseFunction(std::make_shared<Isotropic>(albedo)) {}
-  ConstantMedium(std::shared_ptr<GeoObject> shape, double density, Color color) :
-      shape(shape),
-      negInvDensity(-1 / density),
-      phaseFunction(std::make_shared<Isotropic>(color)) {}
-
-  virtual bool intersect(const Ray& ray, double tMin, double tMax, SInteraction& interaction) const override {
+  // The part of (tMin, tMax) inside the shape, assumed convex.
+  bool overlap(const Ray& ray, Real tMin, Real tMax, Real& tEnter, Real& tExit) const {
     SInteraction interactionA, interactionB;
 
     if (!shape->intersect(ray, -Math::infinity, Math::infinity, interactionA)) return false;
 
     if (!shape->intersect(ray, interactionA.t + 0.0001, Math::infinity, interactionB)) return false;
 
-    if (interactionA.t < tMin) interactionA.t = tMin;
-    if (interactionB.t > tMax) interactionB.t = tMax;
+    tEnter = std::fmax(interactionA.t, tMin);
+    tExit = std::fmin(interactionB.t, tMax);
+    if (tEnter >= tExit) return false;
+
+    if (tEnter < 0) tEnter = 0;
+    return true;
+  }
+
+ public:
+  ConstantMedium(std::shared_ptr<GeoObject> shape, Real density, std::shared_ptr<Texture> albedo) :
+      shape(shape),
+      phaseFunction(std::make_shared<Isotropic>(albedo)),
+      negInvDensity(-1 / density) {}
+  ConstantMedium(std::shared_ptr<GeoObject> shape, Real density, Color color) :
+      shape(shape),
+      phaseFunction(std::make_shared<Isotropic>(color)),
+      negInvDensity(-1 / density) {}
+
+  // The boundary is not a surface; paths meet the medium through sampleFreeFlight() only.
+  virtual bool intersect(const Ray& ray, Real tMin, Real tMax, SInteraction& interaction) const override {
+    return false;
+  }
 
-    if (interactionA.t >= interactionB.t) return false;
+  virtual bool isMedium() const override { return true; }
 
-    if (interactionA.t < 0) interactionA.t = 0;
+  // Scatters an exponentially distributed distance into the part of (tMin, tMax) inside the shape, unless the ray
+  // leaves it first. random is uniform in [0, 1) and stays in double, so the logarithm never sees 0.
+  virtual bool sampleFreeFlight(const Ray& ray, Real tMin, Real tMax, double random,
+                                SInteraction& interaction) const override {
+    Real tEnter, tExit;
+    if (!overlap(ray, tMin, tMax, tEnter, tExit)) return false;
 
     const auto rayLength = ray.direction.magnitude();
-    const auto distanceInsideShape = (interactionB.t - interactionA.t) * rayLength;
-    const auto hitDistance = negInvDensity * std::log(Random::fraction());
+    const auto distanceInsideShape = (tExit - tEnter) * rayLength;
+    const auto hitDistance = negInvDensity * std::log(1.0 - random);
 
     if (hitDistance > distanceInsideShape) return false;
 
-    interaction.t = interactionA.t + hitDistance / rayLength;
+    interaction.t = tEnter + hitDistance / rayLength;
     interaction.point = ray.at(interaction.t);
 
     interaction.normal = Vector3(1, 0, 0);  // arbitrary
     interaction.frontFace = true;           // also arbitrary
-    interaction.materialPtr = phaseFunction;
+    interaction.materialPtr = phaseFunction.get();
 
     return true;
   }
 
-  virtual bool computeBoundingBox(double t0, double t1, AABB& outputBox) const override {
-    return shape->computeBoundingBox(t0, t1, outputBox);
+  virtual double transmittance(const Ray& ray, Real tMin, Real tMax) const override {
+    Real tEnter, tExit;
+    if (!overlap(ray, tMin, tMax, tEnter, tExit)) return 1;
+    return std::exp((tExit - tEnter) * ray.direction.magnitude() / negInvDensity);
   }
 
-	  std::shared_ptr<Material> getMaterial() const override { return phaseFunction; }
+  virtual bool computeBoundingBox(Real t0, Real t1, AABB& outputBox) const override {
+    return shape->computeBoundingBox(t0, t1, outputBox);
+  }
 
+  std::shared_ptr<Material> getMaterial() const override { return phaseFunction; }
 };
 
 #endif
\ No newline at end of file
@@ -1,20 +1,67 @@
 #ifndef GEOMETRICAL_OBJECT_HPP
 #define GEOMETRICAL_OBJECT_HPP
 
+#include <memory>
+#include <vector>
+
 #include "../Core/AxisAlignedBoundingBox.hpp"
 #include "../Core/SurfaceInteraction.hpp"
+#include "../Math/RNG.hpp"
 #include "../Math/Ray.hpp"
+#include "../Math/RayPacket.hpp"
 
 class GeometricalObject {
  public:
-  virtual bool intersect(const Ray& ray, double tMin, double tMax, SInteraction& interaction) const = 0;
-  virtual bool computeBoundingBox(double t0, double t1, AABB& outputBox) const = 0;
-  virtual Point3 samplePoint() const { return Point3(0, 0, 0); }
-  virtual Point3 samplePoint(double random1, double random2) const { return Point3(0, 0, 0); }
-  virtual Ray sampleDirection() const { return Ray(); }
-  virtual Ray sampleDirection(double random1, double random2, double, double) const { return Ray(); }
-  virtual double getArea() const { return 0; }
+  virtual bool intersect(const Ray& ray, Real tMin, Real tMax, SInteraction& interaction) const = 0;
+  virtual bool computeBoundingBox(Real t0, Real t1, AABB& outputBox) const = 0;
+
+  // Any hit query for shadow rays: is there a surface within (tMin, tMax)? Stops at the first hit and fills nothing.
+  virtual bool occluded(const Ray& ray, Real tMin, Real tMax) const {
+    SInteraction interaction;
+    return intersect(ray, tMin, tMax, interaction);
+  }
+
+  // Packet queries over the lanes in laneMask. intersectPacket shrinks tMax and fills interactions for the lanes it
+  // hits and returns their mask; occludedPacket returns the mask of blocked lanes. The defaults trace lane by lane.
+  virtual int intersectPacket(const RayPacket& packet, int laneMask, Real tMin, Real tMax[],
+                              SInteraction interactions[]) const {
+    int hitMask = 0;
+    for (int lane = 0; lane < RayPacket::size; lane++) {
+      if (RayPacket::isSet(laneMask, lane) && intersect(packet.rays[lane], tMin, tMax[lane], interactions[lane])) {
+        tMax[lane] = interactions[lane].t;
+        hitMask |= 1 << lane;
+      }
+    }
+    return hitMask;
+  }
+
+  virtual int occludedPacket(const RayPacket& packet, int laneMask, Real tMin, const Real tMax[]) const {
+    int blockedMask = 0;
+    for (int lane = 0; lane < RayPacket::size; lane++)
+      if (RayPacket::isSet(laneMask, lane) && occluded(packet.rays[lane], tMin, tMax[lane])) blockedMask |= 1 << lane;
+    return blockedMask;
+  }
+
+  virtual Point3 samplePoint(RNG& rng) const { return Point3(0, 0, 0); }
+  virtual Point3 samplePoint(Real random1, Real random2) const { return Point3(0, 0, 0); }
+  virtual Ray sampleDirection(RNG& rng) const { return Ray(); }
+  virtual Ray sampleDirection(Real random1, Real random2, Real, Real) const { return Ray(); }
+  virtual Real getArea() const { return 0; }
+
+  // Participating media have no surface for intersect() to find. The scene keeps them apart and asks where a ray
+  // crossing (tMin, tMax) scatters inside, given one uniform random number from the path's stream, and how much of
+  // the light along a segment gets through.
+  virtual bool isMedium() const { return false; }
+  virtual bool sampleFreeFlight(const Ray& ray, Real tMin, Real tMax, double random, SInteraction& interaction) const {
+    return false;
+  }
+  virtual double transmittance(const Ray& ray, Real tMin, Real tMax) const { return 1; }
+
   virtual std::shared_ptr<Material> getMaterial() const { return nullptr; }
+  // Appends every material a hit on this object can report. Objects holding other objects forward to them.
+  virtual void collectMaterials(std::vector<std::shared_ptr<Material>>& materials) const {
+    if (auto material = getMaterial()) materials.push_back(material);
+  }
 };
 
 using GeoObject = GeometricalObject;
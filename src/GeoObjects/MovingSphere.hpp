@@ -8,14 +8,14 @@ class MovingSphere : public GeometricalObject {
  private:
   Point3 center0;
   Point3 center1;
-  double time0;
-  double time1;
-  double radius;
+  Real time0;
+  Real time1;
+  Real radius;
   std::shared_ptr<Material> material;
 
  public:
   MovingSphere() {}
-  MovingSphere(Point3 center0, Point3 center1, double time0, double time1, double radius,
+  MovingSphere(Point3 center0, Point3 center1, Real time0, Real time1, Real radius,
                std::shared_ptr<Material> material) :
       center0(center0),
       center1(center1),
@@ -24,7 +24,7 @@ class MovingSphere : public GeometricalObject {
       radius(radius),
       material(material) {}
 
-  virtual bool intersect(const Ray& ray, double tMin, double tMax, SInteraction& interaction) const override {
+  virtual bool intersect(const Ray& ray, Real tMin, Real tMax, SInteraction& interaction) const override {
     const Vector3 oc = ray.origin - centerAt(ray.getTime());
     const auto a = ray.direction.magnitudeSquared();
     const auto halfB = dot(oc, ray.direction);
@@ -41,7 +41,7 @@ class MovingSphere : public GeometricalObject {
         interaction.point = ray.at(interaction.t);
         const auto outwardNormal = (interaction.point - centerAt(ray.getTime())) / radius;
         interaction.setFaceNormal(ray, outwardNormal);
-        interaction.materialPtr = material;
+        interaction.materialPtr = material.get();
         return true;
       }
 
@@ -51,25 +51,39 @@ class MovingSphere : public GeometricalObject {
         interaction.point = ray.at(interaction.t);
         const auto outwardNormal = (interaction.point - centerAt(ray.getTime())) / radius;
         interaction.setFaceNormal(ray, outwardNormal);
-        interaction.materialPtr = material;
+        interaction.materialPtr = material.get();
         return true;
       }
     }
     return false;
   }
 
-  virtual bool computeBoundingBox(double t0, double t1, AABB& outputBox) const override {
-    const Point3 minPoint = centerAt(t0) - Vector3(radius, radius, radius);
-    const Point3 maxPoint = centerAt(t0) + Vector3(radius, radius, radius);
-    const auto initBox = AABB(minPoint, maxPoint);
-    const auto finBox = AABB(minPoint, maxPoint);
+  virtual bool occluded(const Ray& ray, Real tMin, Real tMax) const override {
+    const Vector3 oc = ray.origin - centerAt(ray.getTime());
+    const auto a = ray.direction.magnitudeSquared();
+    const auto halfB = dot(oc, ray.direction);
+    const auto c = oc.magnitudeSquared() - radius * radius;
+    const auto discriminant = halfB * halfB - a * c;
+    if (discriminant <= 0) return false;
+
+    const auto root = std::sqrt(discriminant);
+    const auto tNear = (-halfB - root) / a;
+    if (tNear < tMax && tNear > tMin) return true;
+    const auto tFar = (-halfB + root) / a;
+    return tFar < tMax && tFar > tMin;
+  }
+
+  virtual bool computeBoundingBox(Real t0, Real t1, AABB& outputBox) const override {
+    const Vector3 extent(radius, radius, radius);
+    const auto initBox = AABB(centerAt(t0) - extent, centerAt(t0) + extent);
+    const auto finBox = AABB(centerAt(t1) - extent, centerAt(t1) + extent);
     outputBox = AABB::surroundingBox(initBox, finBox);
     return true;
   }
 	
   std::shared_ptr<Material> getMaterial() const override { return material; }
 
-  Point3 centerAt(double time) const { return center0 + ((time - time0) / (time1 - time0)) * (center1 - center0); }
+  Point3 centerAt(Real time) const { return center0 + ((time - time0) / (time1 - time0)) * (center1 - center0); }
 };
 
 #endif
\ No newline at end of file
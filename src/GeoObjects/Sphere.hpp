@@ -7,17 +7,17 @@
 class Sphere : public GeometricalObject {
  private:
   Point3 center;
-  double radius;
+  Real radius;
   std::shared_ptr<Material> material;
 
  public:
   Sphere() {}
-  Sphere(Point3 center, double radius, std::shared_ptr<Material> material) :
+  Sphere(Point3 center, Real radius, std::shared_ptr<Material> material) :
       center(center),
       radius(radius),
       material(material) {}
 
-  virtual bool intersect(const Ray& ray, double tMin, double tMax, SInteraction& interaction) const override {
+  virtual bool intersect(const Ray& ray, Real tMin, Real tMax, SInteraction& interaction) const override {
     Vector3 oc = ray.origin - center;
     const auto a = ray.direction.magnitudeSquared();
     const auto halfB = dot(oc, ray.direction);
@@ -27,28 +27,50 @@ class Sphere : public GeometricalObject {
     const auto root = std::sqrt(discriminant);
     auto t = (-halfB - root) / a;
     if (t < tMax && t > tMin) {
-      interaction.t = t;
-      interaction.point = ray.at(interaction.t);
-      const Vector3 outwardNormal = (interaction.point - center) / radius;
-      interaction.setFaceNormal(ray, outwardNormal);
-      interaction.materialPtr = material;
-      interaction.uv = getUV(outwardNormal);
+      setInteraction(ray, t, interaction);
       return true;
     }
     t = (-halfB + root) / a;
     if (t < tMax && t > tMin) {
-      interaction.t = t;
-      interaction.point = ray.at(interaction.t);
-      const Vector3 outwardNormal = (interaction.point - center) / radius;
-      interaction.setFaceNormal(ray, outwardNormal);
-      interaction.uv = getUV(outwardNormal);
-      interaction.materialPtr = material;
+      setInteraction(ray, t, interaction);
       return true;
     }
     return false;
   }
 
-  virtual bool computeBoundingBox(double t0, double t1, AABB& outputBox) const override {
+  virtual bool occluded(const Ray& ray, Real tMin, Real tMax) const override {
+    const Vector3 oc = ray.origin - center;
+    const auto a = ray.direction.magnitudeSquared();
+    const auto halfB = dot(oc, ray.direction);
+    const auto c = oc.magnitudeSquared() - radius * radius;
+    const auto discriminant = halfB * halfB - a * c;
+    if (discriminant < 0) return false;
+
+    const auto root = std::sqrt(discriminant);
+    const auto tNear = (-halfB - root) / a;
+    if (tNear < tMax && tNear > tMin) return true;
+    const auto tFar = (-halfB + root) / a;
+    return tFar < tMax && tFar > tMin;
+  }
+
+  virtual int intersectPacket(const RayPacket& packet, int laneMask, Real tMin, Real tMax[],
+                              SInteraction interactions[]) const override {
+    Real t[RayPacket::size];
+    const int hitMask = hitPacket(packet, laneMask, tMin, tMax, t);
+    for (int lane = 0; lane < RayPacket::size; lane++) {
+      if (!RayPacket::isSet(hitMask, lane)) continue;
+      setInteraction(packet.rays[lane], t[lane], interactions[lane]);
+      tMax[lane] = t[lane];
+    }
+    return hitMask;
+  }
+
+  virtual int occludedPacket(const RayPacket& packet, int laneMask, Real tMin, const Real tMax[]) const override {
+    Real t[RayPacket::size];
+    return hitPacket(packet, laneMask, tMin, tMax, t);
+  }
+
+  virtual bool computeBoundingBox(Real t0, Real t1, AABB& outputBox) const override {
     // std::cout << "Bounding Box computed for:" << (this) << std::endl;
     outputBox = AABB(center - Vector3(radius, radius, radius), center + Vector3(radius, radius, radius));
     return true;
@@ -56,11 +78,47 @@ class Sphere : public GeometricalObject {
 
   std::shared_ptr<Material> getMaterial() const override { return material; }
 
+  void setInteraction(const Ray& ray, Real t, SInteraction& interaction) const {
+    interaction.t = t;
+    interaction.point = ray.at(interaction.t);
+    const Vector3 outwardNormal = (interaction.point - center) / radius;
+    interaction.setFaceNormal(ray, outwardNormal);
+    interaction.materialPtr = material.get();
+    interaction.uv = getUV(outwardNormal);
+  }
+
+  // Quadratic of every packet lane, without branches so the loop vectorizes. Picks the near root if it lies in
+  // (tMin, tMax) and the far one otherwise, like intersect().
+  int hitPacket(const RayPacket& packet, int laneMask, Real tMin, const Real tMax[], Real t[]) const {
+    int hitMask = 0;
+    for (int lane = 0; lane < RayPacket::size; lane++) {
+      const Real ocX = packet.origin[0][lane] - center.x;
+      const Real ocY = packet.origin[1][lane] - center.y;
+      const Real ocZ = packet.origin[2][lane] - center.z;
+      const Real dX = packet.direction[0][lane];
+      const Real dY = packet.direction[1][lane];
+      const Real dZ = packet.direction[2][lane];
+      const Real a = dX * dX + dY * dY + dZ * dZ;
+      const Real halfB = ocX * dX + ocY * dY + ocZ * dZ;
+      const Real c = (ocX * ocX + ocY * ocY + ocZ * ocZ) - radius * radius;
+      const Real discriminant = halfB * halfB - a * c;
+
+      const Real root = std::sqrt(discriminant > 0 ? discriminant : 0);
+      const Real tNear = (-halfB - root) / a;
+      const Real tFar = (-halfB + root) / a;
+      const bool nearHit = tNear < tMax[lane] && tNear > tMin;
+      t[lane] = nearHit ? tNear : tFar;
+      const bool hit = discriminant >= 0 && t[lane] < tMax[lane] && t[lane] > tMin;
+      hitMask |= hit << lane;
+    }
+    return hitMask & laneMask;
+  }
+
   UV getUV(const Vector3& outwardNormal) const {
     const auto phi = std::atan2(outwardNormal.z, outwardNormal.x);
     const auto theta = std::asin(outwardNormal.y);
-    const double u = 1 - (phi + Math::pi) / (2 * Math::pi);
-    const double v = (theta + Math::pi / 2) / Math::pi;
+    const Real u = 1 - (phi + Math::pi) / (2 * Math::pi);
+    const Real v = (theta + Math::pi / 2) / Math::pi;
     return UV(u, v);
   }
 };
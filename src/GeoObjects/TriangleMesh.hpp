@@ -0,0 +1,309 @@
+#ifndef TRIANGLE_MESH_HPP
+#define TRIANGLE_MESH_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "../Core/BVHTree.hpp"
+#include "../Materials/Material.hpp"
+#include "../Math/ONB.hpp"
+#include "../Math/Random.hpp"
+#include "GeometricalObject.hpp"
+
+// Triangles sharing one vertex array, three indices each, under a BVH of their own. The whole mesh is a single object
+// to the scene, so a Scene, LinearBVH or BVHNode over meshes only sees their boxes. Normals and texture coordinates
+// are per vertex and optional: without normals triangles are flat, without texture coordinates each triangle spans
+// (0,0), (1,0), (1,1). Triangles wind counterclockwise seen from outside.
+class TriangleMesh : public GeometricalObject {
+ private:
+  std::vector<Point3> positions;
+  std::vector<Vector3> normals;
+  std::vector<UV> uvs;
+  std::vector<uint32_t> indices;  // in leaf order of the tree
+  std::shared_ptr<Material> material;
+  BVHTree tree;
+  AABB box;
+
+  // Light sampling picks triangles by area. Only emissive meshes keep the distribution.
+  std::vector<double> areaCDF;
+  double area = 0;
+
+  // Ray direction permuted so that z is its largest component, and the shear taking it onto the z axis. Computed once
+  // per query and shared by all triangles tested.
+  struct Shear {
+    int kx, ky, kz;
+    Real sx, sy, sz;
+
+    explicit Shear(const Vector3& direction) {
+      kz = std::abs(direction.x) > std::abs(direction.y) ? 0 : 1;
+      if (std::abs(direction.z) > std::abs(direction[kz])) kz = 2;
+      kx = (kz + 1) % 3;
+      ky = (kx + 1) % 3;
+      // Keeps the winding, and so the sign of the edge functions, the same for either direction along kz.
+      if (direction[kz] < 0) std::swap(kx, ky);
+      sx = -direction[kx] / direction[kz];
+      sy = -direction[ky] / direction[kz];
+      sz = 1 / direction[kz];
+    }
+  };
+
+  struct Hit {
+    uint32_t triangle;
+    Real b1, b2;  // barycentric weights of the second and third vertex
+  };
+
+  // Watertight ray-triangle test (Woop, Benthin and Wald, "Watertight Ray/Triangle Intersection"). Vertices are moved
+  // into the ray's sheared frame, where the ray runs along z through the origin, and the hit is decided by the signs
+  // of the 2D edge functions. An edge shared by two triangles gives both the same value with opposite signs, so rays
+  // through edges and vertices cannot slip between neighbours. On a hit t becomes the hit distance.
+  bool hitTriangle(uint32_t triangle, const Ray& ray, const Shear& shear, Real tMin, Real& t, Hit& hit) const {
+    const Vector3 a = positions[indices[3 * triangle]] - ray.origin;
+    const Vector3 b = positions[indices[3 * triangle + 1]] - ray.origin;
+    const Vector3 c = positions[indices[3 * triangle + 2]] - ray.origin;
+
+    const Real ax = a[shear.kx] + shear.sx * a[shear.kz];
+    const Real ay = a[shear.ky] + shear.sy * a[shear.kz];
+    const Real bx = b[shear.kx] + shear.sx * b[shear.kz];
+    const Real by = b[shear.ky] + shear.sy * b[shear.kz];
+    const Real cx = c[shear.kx] + shear.sx * c[shear.kz];
+    const Real cy = c[shear.ky] + shear.sy * c[shear.kz];
+
+    Real u = cx * by - cy * bx;
+    Real v = ax * cy - ay * cx;
+    Real w = bx * ay - by * ax;
+    // A zero edge function in single precision may be rounding; double precision settles the edge.
+    if (sizeof(Real) < sizeof(double) && (u == 0 || v == 0 || w == 0)) {
+      u = double(cx) * double(by) - double(cy) * double(bx);
+      v = double(ax) * double(cy) - double(ay) * double(cx);
+      w = double(bx) * double(ay) - double(by) * double(ax);
+    }
+    if ((u < 0 || v < 0 || w < 0) && (u > 0 || v > 0 || w > 0)) return false;
+
+    const Real determinant = u + v + w;
+    if (determinant == 0) return false;
+
+    // Distance scaled by the determinant, compared against the scaled range to defer the division to actual hits.
+    const Real scaledT = u * shear.sz * a[shear.kz] + v * shear.sz * b[shear.kz] + w * shear.sz * c[shear.kz];
+    if (determinant > 0 ? (scaledT <= tMin * determinant || scaledT >= t * determinant)
+                        : (scaledT >= tMin * determinant || scaledT <= t * determinant))
+      return false;
+
+    const Real inverseDeterminant = 1 / determinant;
+    t = scaledT * inverseDeterminant;
+    hit.triangle = triangle;
+    hit.b1 = v * inverseDeterminant;
+    hit.b2 = w * inverseDeterminant;
+    return true;
+  }
+
+  void setInteraction(const Ray& ray, Real t, const Hit& hit, SInteraction& interaction) const {
+    const uint32_t* vertex = &indices[3 * hit.triangle];
+    const Point3& p0 = positions[vertex[0]];
+    const Vector3 edge1 = positions[vertex[1]] - p0;
+    const Vector3 edge2 = positions[vertex[2]] - p0;
+    const Real b0 = 1 - hit.b1 - hit.b2;
+
+    // Interpolated rather than ray.at(t), which keeps the point on the triangle's plane.
+    interaction.point = p0 + hit.b1 * edge1 + hit.b2 * edge2;
+    interaction.t = t;
+    interaction.setFaceNormal(ray, cross(edge1, edge2).normalized());
+    if (!normals.empty()) {
+      Vector3 shadingNormal =
+          (b0 * normals[vertex[0]] + hit.b1 * normals[vertex[1]] + hit.b2 * normals[vertex[2]]).normalized();
+      // On the side of the geometric normal the ray sees.
+      if (dot(shadingNormal, interaction.normal) < 0) shadingNormal = -shadingNormal;
+      interaction.normal = shadingNormal;
+    }
+    if (uvs.empty()) {
+      interaction.uv = UV(hit.b1 + hit.b2, hit.b2);
+    } else {
+      const UV& uv0 = uvs[vertex[0]];
+      const UV& uv1 = uvs[vertex[1]];
+      const UV& uv2 = uvs[vertex[2]];
+      interaction.uv = UV(b0 * uv0.u + hit.b1 * uv1.u + hit.b2 * uv2.u, b0 * uv0.v + hit.b1 * uv1.v + hit.b2 * uv2.v);
+    }
+    interaction.materialPtr = material.get();
+  }
+
+  Real triangleArea(uint32_t triangle) const {
+    const Point3& p0 = positions[indices[3 * triangle]];
+    const Vector3 edge1 = positions[indices[3 * triangle + 1]] - p0;
+    const Vector3 edge2 = positions[indices[3 * triangle + 2]] - p0;
+    return 0.5 * cross(edge1, edge2).magnitude();
+  }
+
+  // Uniform point on the mesh: random1 picks a triangle by area and is then stretched back over [0, 1).
+  Point3 sampleSurface(Real random1, Real random2, Vector3& normal) const {
+    const double u = random1 * area;
+    const size_t triangle =
+        std::min<size_t>(std::upper_bound(areaCDF.begin(), areaCDF.end(), u) - areaCDF.begin(), areaCDF.size() - 1);
+    const double below = triangle > 0 ? areaCDF[triangle - 1] : 0;
+    const double width = areaCDF[triangle] - below;
+    const double remapped = width > 0 ? std::min((u - below) / width, 1.0) : 0;
+
+    const Point3& p0 = positions[indices[3 * triangle]];
+    const Vector3 edge1 = positions[indices[3 * triangle + 1]] - p0;
+    const Vector3 edge2 = positions[indices[3 * triangle + 2]] - p0;
+    normal = cross(edge1, edge2).normalized();
+    const Real root = std::sqrt(remapped);
+    return p0 + (root * (1 - random2)) * edge1 + (root * random2) * edge2;
+  }
+
+ public:
+  TriangleMesh() {}
+  // indices holds three vertex indices per triangle. normals and uvs are either empty or as long as positions.
+  TriangleMesh(std::vector<Point3> positions, std::vector<uint32_t> indices, std::shared_ptr<Material> material,
+               std::vector<Vector3> normals = {}, std::vector<UV> uvs = {},
+               const BVHBuildOptions& options = BVHBuildOptions()) :
+      positions(std::move(positions)),
+      normals(std::move(normals)),
+      uvs(std::move(uvs)),
+      material(material) {
+    if (!this->normals.empty() && this->normals.size() != this->positions.size()) {
+      std::cerr << "TriangleMesh: " << this->normals.size() << " normals for " << this->positions.size()
+                << " vertices, ignoring them." << std::endl;
+      this->normals.clear();
+    }
+    if (!this->uvs.empty() && this->uvs.size() != this->positions.size()) {
+      std::cerr << "TriangleMesh: " << this->uvs.size() << " texture coordinates for " << this->positions.size()
+                << " vertices, ignoring them." << std::endl;
+      this->uvs.clear();
+    }
+
+    // Triangles referring to missing vertices are dropped.
+    const size_t triangleCount = indices.size() / 3;
+    std::vector<AABB> boxes;
+    std::vector<uint32_t> validTriangles;
+    boxes.reserve(triangleCount);
+    validTriangles.reserve(triangleCount);
+    for (size_t i = 0; i < triangleCount; i++) {
+      const uint32_t* vertex = &indices[3 * i];
+      if (vertex[0] >= this->positions.size() || vertex[1] >= this->positions.size() ||
+          vertex[2] >= this->positions.size())
+        continue;
+      const Point3& p0 = this->positions[vertex[0]];
+      const Point3& p1 = this->positions[vertex[1]];
+      const Point3& p2 = this->positions[vertex[2]];
+      boxes.push_back(AABB(Point3(std::fmin(p0.x, std::fmin(p1.x, p2.x)), std::fmin(p0.y, std::fmin(p1.y, p2.y)),
+                                  std::fmin(p0.z, std::fmin(p1.z, p2.z))),
+                           Point3(std::fmax(p0.x, std::fmax(p1.x, p2.x)), std::fmax(p0.y, std::fmax(p1.y, p2.y)),
+                                  std::fmax(p0.z, std::fmax(p1.z, p2.z)))));
+      validTriangles.push_back(i);
+    }
+    if (validTriangles.size() < triangleCount)
+      std::cerr << "TriangleMesh: dropped " << triangleCount - validTriangles.size()
+                << " triangles with out of range indices." << std::endl;
+
+    tree.build(boxes, options);
+    boxes = std::vector<AABB>();
+
+    // Store the triangles in leaf order so leaves address them directly.
+    this->indices.reserve(3 * validTriangles.size());
+    for (const auto index : tree.getPrimitiveOrder())
+      for (int k = 0; k < 3; k++) this->indices.push_back(indices[3 * validTriangles[index] + k]);
+    if (!tree.empty()) box = tree.getBounds();
+
+    for (uint32_t i = 0; i < getTriangleCount(); i++) {
+      area += triangleArea(i);
+      if (material && material->isEmissive()) areaCDF.push_back(area);
+    }
+  }
+
+  size_t getTriangleCount() const { return indices.size() / 3; }
+  size_t getVertexCount() const { return positions.size(); }
+  const BVHTree& getTree() const { return tree; }
+
+  bool intersect(const Ray& ray, Real tMin, Real tMax, SInteraction& interaction) const override {
+    const Shear shear(ray.direction);
+    Hit closest;
+    Real closestT = tMax;
+    const bool hitAnything = tree.intersect(ray, tMin, tMax, [&](uint32_t triangle, Real& closestSoFar) {
+      if (!hitTriangle(triangle, ray, shear, tMin, closestSoFar, closest)) return false;
+      closestT = closestSoFar;
+      return true;
+    });
+    if (hitAnything) setInteraction(ray, closestT, closest, interaction);
+    return hitAnything;
+  }
+
+  bool occluded(const Ray& ray, Real tMin, Real tMax) const override {
+    const Shear shear(ray.direction);
+    return tree.occluded(ray, tMin, tMax, [&](uint32_t triangle) {
+      Real t = tMax;
+      Hit hit;
+      return hitTriangle(triangle, ray, shear, tMin, t, hit);
+    });
+  }
+
+  int intersectPacket(const RayPacket& packet, int laneMask, Real tMin, Real tMax[],
+                      SInteraction interactions[]) const override {
+    const Shear shears[RayPacket::size] = {Shear(packet.rays[0].direction), Shear(packet.rays[1].direction),
+                                           Shear(packet.rays[2].direction), Shear(packet.rays[3].direction)};
+    Hit closest[RayPacket::size];
+    auto leafFunction = [&](uint32_t triangle, int mask, Real* closestSoFar) {
+      int triangleMask = 0;
+      for (int lane = 0; lane < RayPacket::size; lane++)
+        if (RayPacket::isSet(mask, lane) &&
+            hitTriangle(triangle, packet.rays[lane], shears[lane], tMin, closestSoFar[lane], closest[lane]))
+          triangleMask |= 1 << lane;
+      return triangleMask;
+    };
+    const int hitMask = tree.intersect(packet, laneMask, tMin, tMax, leafFunction);
+    for (int lane = 0; lane < RayPacket::size; lane++)
+      if (RayPacket::isSet(hitMask, lane))
+        setInteraction(packet.rays[lane], tMax[lane], closest[lane], interactions[lane]);
+    return hitMask;
+  }
+
+  int occludedPacket(const RayPacket& packet, int laneMask, Real tMin, const Real tMax[]) const override {
+    const Shear shears[RayPacket::size] = {Shear(packet.rays[0].direction), Shear(packet.rays[1].direction),
+                                           Shear(packet.rays[2].direction), Shear(packet.rays[3].direction)};
+    return tree.occluded(packet, laneMask, tMin, tMax, [&](uint32_t triangle, int mask) {
+      int blockedMask = 0;
+      for (int lane = 0; lane < RayPacket::size; lane++) {
+        Real t = tMax[lane];
+        Hit hit;
+        if (RayPacket::isSet(mask, lane) && hitTriangle(triangle, packet.rays[lane], shears[lane], tMin, t, hit))
+          blockedMask |= 1 << lane;
+      }
+      return blockedMask;
+    });
+  }
+
+  bool computeBoundingBox(Real t0, Real t1, AABB& outputBox) const override {
+    outputBox = box;
+    return !tree.empty();
+  }
+
+  // Emissive meshes can be sampled as lights; they emit along the geometric normal.
+  Point3 samplePoint(RNG& rng) const override {
+    const Real random1 = Random::fraction(rng);
+    return samplePoint(random1, Random::fraction(rng));
+  }
+  Point3 samplePoint(Real random1, Real random2) const override {
+    Vector3 normal;
+    return areaCDF.empty() ? Point3(0, 0, 0) : sampleSurface(random1, random2, normal);
+  }
+
+  Ray sampleDirection(RNG& rng) const override {
+    Real random[4];
+    for (auto& value : random) value = Random::fraction(rng);
+    return sampleDirection(random[0], random[1], random[2], random[3]);
+  }
+  Ray sampleDirection(Real random1, Real random2, Real random3, Real random4) const override {
+    if (areaCDF.empty()) return Ray();
+    Vector3 normal;
+    const Point3 origin = sampleSurface(random1, random2, normal);
+    ONB orthonormalBasis(normal);
+    return Ray(origin, orthonormalBasis.local(Random::cosineDirection(random3, random4)));
+  }
+
+  Real getArea() const override { return area; }
+  std::shared_ptr<Material> getMaterial() const override { return material; }
+};
+
+#endif
@@ -1,9 +1,10 @@
 #ifndef BDP_PATH_INTEGRATOR_HPP
 #define BDP_PATH_INTEGRATOR_HPP
 
-#include "../Core/Stopwatch.hpp"
+#include "../Core/TileScheduler.hpp"
 #include "../PathUtils/Path.hpp"
 #include "../PathUtils/PathContribution.hpp"
+#include "../PathUtils/PathView.hpp"
 #include "Integrator.hpp"
 
 // TODO: Scale the accumulate with b / scalarContrib.
@@ -16,29 +17,23 @@ class BidirectionalPathIntegrator : public Integrator {
   int maxEvents;
 
   double lightArea;
-  double normConstant;
+  double misPower;
+
+  // Scratch paths and contribution list of one worker, reused for every sample so that tracing and connecting the
+  // subpaths does not allocate once their capacity is reached.
+  struct PathArena {
+    Path cameraPath;
+    Path lightPath;
+    PathContribution contribution;
+    PathArena(int maxEvents) : cameraPath(maxEvents), lightPath(maxEvents), contribution(maxEvents) {}
+  };
 
  public:
   BidirectionalPathIntegrator(const Config& config, const Scene& scene, const Camera& camera) :
       Integrator(config, scene, camera) {
     lightArea = getTotalLightArea();
     maxEvents = bounceLimit + 1;
-    normConstant = estimateNormalizationConstant(10000);
-  }
-
-  double estimateNormalizationConstant(uint sampleCount) {
-    std::cout << "Estimating normalization constant" << std::endl;
-    Stopwatch stopwatch;
-    stopwatch.start();
-    double b = 0.0;
-    for (int i = 0; i < sampleCount; i++) {
-      b += combinePaths(generateCameraPath(), generateLightPath()).scalarContrib;
-    }
-    b /= double(sampleCount);
-    stopwatch.stop();
-    std::cout << "Normalization constant estimated: " << b << std::endl;
-    stopwatch.printTime();
-    return b;
+    misPower = config.misPower;
   }
 
   double getTotalLightArea() {
@@ -47,92 +42,125 @@ class BidirectionalPathIntegrator : public Integrator {
     return area;
   }
 
-  void tracePath(const Ray& ray, int bounceLimit, Path& path) const {
+  void tracePath(const Ray& ray, int bounceLimit, Path& path, RNG& rng) const {
     if (bounceLimit <= 0) return;
     SurfaceInteraction interaction;
 
     // If a ray does not hit anything in the scene, return background color
-    if (!scene.intersect(ray, 0.001, Math::infinity, interaction)) return;
+    if (!scene.intersect(ray, 0.001, Math::infinity, interaction, rng)) return;
 
     // set path data
-    path.add(Vertex(interaction));
+    path.add(Vertex(interaction, scene.getMaterialId(*interaction.materialPtr)));
 		
-    bool hitLight = dynamic_cast<DiffuseLight*>(&*(interaction.materialPtr));
-    if (hitLight) return;
+    if (interaction.materialPtr->isEmissive()) return;
 
     Ray scattered;
     Color attenuation;
-    if (interaction.materialPtr->scatter(ray, interaction, attenuation, scattered)) {
-      tracePath(scattered, bounceLimit - 1, path);
+    if (getMaterial(interaction).scatter(ray, interaction, attenuation, scattered, rng)) {
+      tracePath(scattered, bounceLimit - 1, path, rng);
     }
   }
 
-  void render(Image& image) const override {
-    for (int j = imageHeight - 1; j >= 0; --j) {
-      std::cout << "\rScanlines remaining: " << j << "  " << std::flush;
-      for (int i = 0; i < imageWidth; ++i) {
-        for (int s = 0; s < samplesPerPixel; ++s) {
-          combinePaths(generateCameraPath(i, j), generateLightPath()).accumulatePathContribution(1.0, image);
+  void renderPass(Image& image, int pass) const override {
+    TileScheduler scheduler(imageHeight, imageWidth, threadCount);
+
+    // Light tracing strategies splat to arbitrary pixels, so every worker accumulates into its own film and the films
+    // are added to the image once the pass is done.
+    std::vector<Image> films(scheduler.getThreadCount(), Image(imageHeight, imageWidth));
+    std::vector<PathArena> arenas(scheduler.getThreadCount(), PathArena(maxEvents));
+    scheduler.run([this, &films, &arenas, pass](const Tile& tile, unsigned threadIndex) {
+      Image& film = films[threadIndex];
+      PathArena& arena = arenas[threadIndex];
+      for (size_t j = tile.y0; j < tile.y1; ++j) {
+        for (size_t i = tile.x0; i < tile.x1; ++i) {
+          RNG rng = Random::pixelStream(j * imageWidth + i, pass);
+          for (int s = 0; s < samplesPerPixel; ++s) {
+            generateCameraPath(i, j, rng, arena.cameraPath);
+            generateLightPath(rng, arena.lightPath);
+            combinePaths(arena.cameraPath, arena.lightPath, arena.contribution);
+            arena.contribution.accumulatePathContribution(1.0, film);
+          }
         }
       }
-    }
+    });
+    for (const auto& film : films) image += film;
   }
 
-  Path generateCameraPath() const {
+  Path generateCameraPath(RNG& rng) const {
     Path path(maxEvents);
-    Ray ray = camera.getSample(imageHeight, imageWidth);
+    Ray ray = camera.getSample(imageHeight, imageWidth, rng);
     path.add(Vertex(ray.origin, camera.getW()));
-    tracePath(ray, bounceLimit, path);
+    tracePath(ray, bounceLimit, path, rng);
+    cacheDensities(path, false);
     return path;
   }
 
-  Path generateCameraPath(ushort pixelX, ushort pixelY) const {
+  Path generateCameraPath(ushort pixelX, ushort pixelY, RNG& rng) const {
     Path path(maxEvents);
-    Ray ray = camera.getRay(sampler.getRandomSample(pixelX, pixelY));
-    path.add(Vertex(ray.origin, camera.getW()));
-    tracePath(ray, bounceLimit, path);
+    generateCameraPath(pixelX, pixelY, rng, path);
     return path;
   }
 
-  Path generateLightPath() const {
+  // Traces into path, replacing its vertices.
+  void generateCameraPath(ushort pixelX, ushort pixelY, RNG& rng, Path& path) const {
+    path.clear();
+    Ray ray = camera.getRay(sampler.getRandomSample(pixelX, pixelY, rng), rng);
+    path.add(Vertex(ray.origin, camera.getW()));
+    tracePath(ray, bounceLimit, path, rng);
+    cacheDensities(path, false);
+  }
+
+  Path generateLightPath(RNG& rng) const {
     Path path(maxEvents);
-    auto randomLight = scene.getRandomLight();
-    auto lightMaterial = scene.getRandomLight()->getMaterial();
-    Ray ray = randomLight->sampleDirection();
-    path.add(Vertex(ray.origin, ray.direction, lightMaterial));
-    tracePath(ray, bounceLimit, path);
+    generateLightPath(rng, path);
     return path;
   }
 
-  bool isConnectable(const Path& camPath, const Path& lightPath, double& px, double& py) const {
+  // Traces into path, replacing its vertices.
+  void generateLightPath(RNG& rng, Path& path) const {
+    path.clear();
+    auto randomLight = scene.getRandomLight(rng);
+    Ray ray = randomLight->sampleDirection(rng);
+    const Material& lightMaterial = *randomLight->getMaterial();
+    path.add(Vertex(ray.origin, ray.direction, lightMaterial, scene.getMaterialId(lightMaterial)));
+    tracePath(ray, bounceLimit, path, rng);
+    cacheDensities(path, true);
+  }
+
+  // The eye subpath ends at path[numEyeVertices - 1], the light subpath at path[numEyeVertices]. transmittance is the
+  // fraction of the light the media let through along the connection, which is not sampled.
+  bool isConnectable(const PathView& path, double& px, double& py, double& transmittance) const {
+    const int numEyeVertices = path.getNumEyeVertices();
+    const int numLightVertices = path.getNumLightVertices();
     Vector3 direction;
     bool result;
+    transmittance = 1;
 
-    // Dummy
-    SInteraction interaction;
-
-    if (camPath.empty() && (lightPath.length() >= 2)) {
+    if (numEyeVertices == 0 && numLightVertices >= 2) {
       // No direct hit to the film (pinhole)
       result = false;
-    } else if ((camPath.length() >= 2) && lightPath.empty()) {
+    } else if (numEyeVertices >= 2 && numLightVertices == 0) {
       // Direct hit to the light source
-      direction = (camPath[1].point - camPath[0].point).normalized();
-      bool isLastVertLight = dynamic_cast<DiffuseLight*>(&*(camPath.last().materialPtr));
-      result = isLastVertLight;
+      direction = (path[1].point - path[0].point).normalized();
+      result = path[numEyeVertices - 1].isEmissive();
 
-    } else if ((camPath.length() == 1) && (lightPath.length() >= 1)) {
+    } else if (numEyeVertices == 1 && numLightVertices >= 1) {
       // light tracing
-      Ray ray(camPath.first().point, (lightPath.last().point - camPath.first().point).normalized());
-      double tMax = (lightPath.last().point - camPath.first().point).magnitude() / ray.direction.magnitude();
+      Ray ray(path[0].point, (path[1].point - path[0].point).normalized());
+      double tMax = (path[1].point - path[0].point).magnitude() / ray.direction.magnitude();
       direction = ray.direction;
-      result = !scene.intersect(ray, 0, tMax, interaction);
+      result = !scene.occluded(ray, 0, tMax);
+      if (result) transmittance = scene.transmittance(ray, 0, tMax);
     } else {
       // shadow ray connection
-      Ray ray(camPath.last().point, (lightPath.last().point - camPath.last().point).normalized());
-      double tMax = (lightPath.last().point - camPath.last().point).magnitude() / ray.direction.magnitude();
-      direction = (camPath[1].point - camPath[0].point).normalized();
-
-      result = !scene.intersect(ray, 0, tMax, interaction);
+      const Vertex& eyeEnd = path[numEyeVertices - 1];
+      const Vertex& lightEnd = path[numEyeVertices];
+      Ray ray(eyeEnd.point, (lightEnd.point - eyeEnd.point).normalized());
+      double tMax = (lightEnd.point - eyeEnd.point).magnitude() / ray.direction.magnitude();
+      direction = (path[1].point - path[0].point).normalized();
+
+      result = !scene.occluded(ray, 0, tMax);
+      if (result) transmittance = scene.transmittance(ray, 0, tMax);
     }
     if (!result) return result;
     // get the pixel location
@@ -146,6 +174,9 @@ class BidirectionalPathIntegrator : public Integrator {
     return result && ((px >= 0) && (px < imageWidth) && (py >= 0) && (py < imageHeight));
   }
 
+  using Integrator::getMaterial;
+  const MaterialVariant& getMaterial(const Vertex& vertex) const { return scene.getMaterialVariant(vertex.materialId); }
+
   inline double geometryTerm(const Vertex& e0, const Vertex& e1) const {
     const Vector3 distVec = e1.point - e0.point;
     const double distSquared = distVec.magnitudeSquared();
@@ -158,7 +189,7 @@ class BidirectionalPathIntegrator : public Integrator {
     return std::abs(dot(next.normal, dv)) / (d2 * sqrt(d2));
   }
 
-  Color pathThroughput(const Path& path) const {
+  Color pathThroughput(const PathView& path) const {
     Color color = Color(1.0, 1.0, 1.0);
     for (int i = 0; i < path.length(); i++) {
       if (i == 0) {
@@ -172,23 +203,21 @@ class BidirectionalPathIntegrator : public Integrator {
         W /= (c / ds2);
         color *= (W * std::abs(dot(outgoing, path[1].normal) / dist2));
       } else if (i == (path.length() - 1)) {
-        bool isVertLight = dynamic_cast<DiffuseLight*>(&*(path[i].materialPtr));
-        if (isVertLight) {
+        if (path[i].isEmissive()) {
           // Incident direction to the last vertex (if it is on a light)
+          const MaterialVariant& material = getMaterial(path[i]);
           const Vector3 incoming = (path[i - 1].point - path[i].point).normalized();
-          const double L = path[i].materialPtr->brdf(incoming, path[i].normal, incoming);
-          color *= path[i].materialPtr->getColor(path[i].interaction.uv, path[i].interaction.point) * L;
+          const double L = material.brdf(incoming, path[i].normal, incoming);
+          color *= material.getColor(path[i].uv, path[i].point) * L;
         } else {
           color *= 0.0;
         }
       } else {
         const Vector3 incoming = (path[i - 1].point - path[i].point).normalized();
         const Vector3 reflected = (path[i + 1].point - path[i].point).normalized();
-        double BRDF = 0.0;
-        if (path[i].materialPtr != nullptr) { BRDF = path[i].materialPtr->brdf(incoming, path[i].normal, reflected); }
-        const UV uv = path[i].interaction.uv;
-        const Point3 point = path[i].interaction.point;
-        const Color materialColor = path[i].materialPtr->getColor(uv, point);
+        const MaterialVariant& material = getMaterial(path[i]);
+        const double BRDF = material.brdf(incoming, path[i].normal, reflected);
+        const Color materialColor = material.getColor(path[i].uv, path[i].point);
         const double geometryTermVal = geometryTerm(path[i], path[i + 1]);
         color *= materialColor * BRDF * geometryTermVal;
       }
@@ -199,6 +228,14 @@ class BidirectionalPathIntegrator : public Integrator {
 
   PathContribution combinePaths(const Path& cameraPath, const Path& lightPath) const {
     PathContribution result(maxEvents);
+    combinePaths(cameraPath, lightPath, result);
+    return result;
+  }
+
+  // Evaluates every connection strategy into result, replacing its contents. Works on views of the two subpaths, so
+  // it allocates nothing once result has grown to the number of strategies.
+  void combinePaths(const Path& cameraPath, const Path& lightPath, PathContribution& result) const {
+    result.clear();
     int maxPathLength = std::fmin(cameraPath.length() + lightPath.length(), maxEvents);
     // maxEvents = the maximum number of vertices
     for (int pathLength = minPathLength; pathLength < maxPathLength; pathLength++) {
@@ -209,24 +246,19 @@ class BidirectionalPathIntegrator : public Integrator {
         if (numEyeVertices > cameraPath.length()) continue;
         if (numLightVertices > lightPath.length()) continue;
 
-        // Extract subpaths.
-        Path eyeSubpath(cameraPath.firstN(numEyeVertices));
-        Path lightSubpath(lightPath.firstN(numLightVertices));
+        // The full path: the eye subpath followed by the reversed light subpath.
+        const PathView sampledPath(cameraPath, numEyeVertices, lightPath, numLightVertices);
 
         // Check the path visibility.
-        double px = -1.0, py = -1.0;
-        if (!isConnectable(eyeSubpath, lightSubpath, px, py)) continue;
-
-        // Construct a full path.
-        Path sampledPath(pathLength);
-        sampledPath.append(eyeSubpath);
-        sampledPath.append(lightPath.reversed());
+        double px = -1.0, py = -1.0, transmittance = 1.0;
+        if (!isConnectable(sampledPath, px, py, transmittance)) continue;
 
         // Evaluate the path
-        Color color = pathThroughput(sampledPath);
-        double pathPDF = pathProbablityDensity(sampledPath, pathLength, numEyeVertices, numLightVertices);
-        double weight = calculateMISWeight(sampledPath, numEyeVertices, numLightVertices, pathLength);
-        if ((weight <= 0.0) || (pathPDF <= 0.0)) continue;
+        Color color = pathThroughput(sampledPath) * transmittance;
+        double pathPDF = pathProbablityDensity(sampledPath);
+        if (pathPDF <= 0.0) continue;
+        double weight = calculateMISWeight(sampledPath);
+        if (weight <= 0.0) continue;
 
         auto scalar = (weight / pathPDF);
         if (std::isinf(scalar)) continue;
@@ -243,103 +275,97 @@ class BidirectionalPathIntegrator : public Integrator {
         result.scalarContrib = std::fmax(color.maxComponent(), result.scalarContrib);
       }
     }
-    return result;
   }
 
-  double calculateMISWeight(const Path& sampledPath, const int numEyeVertices, const int numLightVertices,
-                            const int pathLength) const {
-    const double sampledPathPDF = pathProbablityDensity(sampledPath, pathLength, numEyeVertices, numLightVertices);
-    const double pathPDF = pathProbablityDensity(sampledPath, pathLength);
-    if ((sampledPathPDF == 0.0) || (pathPDF == 0.0)) {
-      return 0.0;
-    } else {
-      return std::fmax(std::fmin(sampledPathPDF / pathPDF, 1.0), 0.0);
-    }
+  // Area densities of the three ways a vertex gets sampled: through the camera, by emission from the light, and by
+  // scattering at current after arriving from previous.
+  double cameraPDF(const Vertex& eye, const Vertex& next) const {
+    double pdfValue = 1.0 / double(imageWidth * imageHeight);
+    const Vector3 outgoing = (next.point - eye.point).normalized();
+    const double cosTheta = dot(outgoing, camera.getW());
+    double distanceToScreen2 = camera.getDist(imageHeight) / cosTheta;
+    distanceToScreen2 = distanceToScreen2 * distanceToScreen2;
+    pdfValue /= (cosTheta / distanceToScreen2);
+    return pdfValue * directionToArea(eye, next);
   }
 
-  double lambertianPDF(const Vector3& wi, const Vector3& normal, const Vector3& wo) const {
-    return std::abs(dot(wo, normal)) / Math::pi;
+  double emissionPDF(const Vertex& light, const Vertex& next) const {
+    const Vector3 outgoing = (next.point - light.point).normalized();
+    return lambertianPDF(light.normal, light.normal, outgoing) * directionToArea(light, next);
   }
 
-  double pathProbablityDensity(const Path& sampledPath, const int pathLength, const int specifiedNumEyeVertices = -1,
-                               const int specifiedNumLightVertices = -1) const {
-    KahanAdder sumPDFs(0.0);
-    bool specified = (specifiedNumEyeVertices != -1) && (specifiedNumLightVertices != -1);
-
-    // number of eye subpath vertices
-    for (int numEyeVertices = 0; numEyeVertices <= pathLength + 1; numEyeVertices++) {
-      // extended BPT
-      double pdfValue = 1.0;
-
-      // number of light subpath vertices
-      int numLightVertices = (pathLength + 1) - numEyeVertices;
-
-      // we have pinhole camera
-      if (numEyeVertices == 0) continue;
-
-      // add all?
-      if (specified && ((numEyeVertices != specifiedNumEyeVertices) || (numLightVertices != specifiedNumLightVertices)))
-        continue;
-
-      // sampling from the eye
-      for (int i = -1; i <= numEyeVertices - 2; i++) {
-        if (i == -1) {
-          // PDF of sampling the camera position (the same delta function with the scaling 1.0 for all the PDFs - they
-          // cancel out)
-          pdfValue *= 1.0;
-        } else if (i == 0) {
-          pdfValue *= 1.0 / double(imageWidth * imageHeight);
-          // Outgoing vector from camera.
-          Vector3 outgoing = (sampledPath[1].point - sampledPath[0].point).normalized();
-          double cosTheta = dot(outgoing, camera.getW());
-          double distanceToScreen2 = camera.getDist(imageHeight) / cosTheta;
-          distanceToScreen2 = distanceToScreen2 * distanceToScreen2;
-          pdfValue /= (cosTheta / distanceToScreen2);
-
-          pdfValue *= directionToArea(sampledPath[0], sampledPath[1]);
-        } else {
-          // PDF of sampling ith vertex
-          Vector3 incoming = (sampledPath[i - 1].point - sampledPath[i].point).normalized();
-          Vector3 reflected = (sampledPath[i + 1].point - sampledPath[i].point).normalized();
+  double scatterPDF(const Vertex& previous, const Vertex& current, const Vertex& next) const {
+    double pdfValue = 1.0;
+    if (current.hasMaterial()) {
+      const Vector3 incoming = (previous.point - current.point).normalized();
+      const Vector3 reflected = (next.point - current.point).normalized();
+      pdfValue = getMaterial(current).pdf(incoming, current.normal, reflected);
+    }
+    return pdfValue * directionToArea(current, next);
+  }
 
-          if (sampledPath[i].materialPtr != nullptr) {
-            pdfValue *= sampledPath[i].materialPtr->pdf(incoming, sampledPath[i].normal, reflected);
-          }
+  // Caches the forward and, where it does not depend on the connection, the reverse density of every vertex.
+  void cacheDensities(Path& path, bool isLightPath) const {
+    for (int i = 0; i < path.length(); i++) {
+      if (i == 0)
+        path[i].pdfForward = isLightPath ? 1.0 / lightArea : 1.0;
+      else if (i == 1)
+        path[i].pdfForward = isLightPath ? emissionPDF(path[0], path[1]) : cameraPDF(path[0], path[1]);
+      else
+        path[i].pdfForward = scatterPDF(path[i - 2], path[i - 1], path[i]);
+      path[i].pdfReverse = i + 2 < path.length() ? scatterPDF(path[i + 2], path[i + 1], path[i]) : 0.0;
+    }
+  }
 
-          pdfValue *= directionToArea(sampledPath[i], sampledPath[i + 1]);
-        }
-      }
+  // Density of x_m of the full path x_0..x_k when sampled from the camera side. Densities next to the connection are
+  // evaluated here, the others come from the cache.
+  double eyeDensity(const PathView& path, int m) const {
+    const int numEyeVertices = path.getNumEyeVertices();
+    if (m < numEyeVertices) return path[m].pdfForward;
+    if (m == 1) return cameraPDF(path[0], path[1]);
+    if (m <= numEyeVertices + 1) return scatterPDF(path[m - 2], path[m - 1], path[m]);
+    return path[m].pdfReverse;
+  }
 
-      if (pdfValue != 0.0) {
-        // sampling from the light source
-        for (int i = -1; i <= numLightVertices - 2; i++) {
-          if (i == -1) {
-            // PDF of sampling the light position (assume area-based sampling)
-            pdfValue *= (1.0 / lightArea);
-          } else if (i == 0) {
-            // Outgoing vector from camera.
-            Vector3 outgoing = (sampledPath[pathLength - 1].point - sampledPath[pathLength].point).normalized();
-            pdfValue *= lambertianPDF(sampledPath[pathLength].normal, sampledPath[pathLength].normal, outgoing);
-            pdfValue *= directionToArea(sampledPath[pathLength], sampledPath[pathLength - 1]);
-          } else {
-            // PDF of sampling (pathLength - i)th vertex
-            Vector3 inc = (sampledPath[pathLength - (i - 1)].point - sampledPath[pathLength - i].point).normalized();
-            Vector3 ref = (sampledPath[pathLength - (i + 1)].point - sampledPath[pathLength - i].point).normalized();
-
-            if (sampledPath[pathLength - i].materialPtr != nullptr)
-              pdfValue *= sampledPath[pathLength - i].materialPtr->pdf(inc, sampledPath[pathLength - i].normal, ref);
-
-            pdfValue *= directionToArea(sampledPath[pathLength - i], sampledPath[pathLength - (i + 1)]);
-          }
-        }
-      }
-      if (specified && (numEyeVertices == specifiedNumEyeVertices) && (numLightVertices == specifiedNumLightVertices))
-        return pdfValue;
+  // Density of x_m of the full path when sampled from the light side.
+  double lightDensity(const PathView& path, int m) const {
+    const int numEyeVertices = path.getNumEyeVertices();
+    const int k = path.length() - 1;
+    if (m >= numEyeVertices) return path[m].pdfForward;
+    if (m == k) return 1.0 / lightArea;
+    if (m == k - 1) return emissionPDF(path[k], path[k - 1]);
+    if (m >= numEyeVertices - 2) return scatterPDF(path[m + 2], path[m + 1], path[m]);
+    return path[m].pdfReverse;
+  }
+
+  // Density of the strategy that sampled the path: the forward densities of both subpaths.
+  double pathProbablityDensity(const PathView& sampledPath) const {
+    double pdfValue = 1.0;
+    for (int m = 1; m < sampledPath.length(); m++) pdfValue *= sampledPath[m].pdfForward;
+    return pdfValue;
+  }
 
-      // sum the probability density (use Kahan summation algorithm to reduce numerical issues)
-      sumPDFs.add(pdfValue);
+  // Balance (misPower 1) or power heuristic weight of the sampling strategy among all strategies with at least one
+  // eye vertex. Uses p_{s+1} / p_s = eyeDensity(x_s) / lightDensity(x_s), so it is O(k) in the path length. Every
+  // density divided by is a factor of p_s, which the caller has checked to be nonzero.
+  double calculateMISWeight(const PathView& sampledPath) const {
+    const int numEyeVertices = sampledPath.getNumEyeVertices();
+    double sum = 1.0;
+    double ratio = 1.0;
+    for (int m = numEyeVertices; m < sampledPath.length(); m++) {
+      ratio *= eyeDensity(sampledPath, m) / lightDensity(sampledPath, m);
+      sum += std::pow(ratio, misPower);
     }
-    return sumPDFs.sum;
+    ratio = 1.0;
+    for (int m = numEyeVertices - 1; m >= 1; m--) {
+      ratio *= lightDensity(sampledPath, m) / eyeDensity(sampledPath, m);
+      sum += std::pow(ratio, misPower);
+    }
+    return 1.0 / sum;
+  }
+
+  double lambertianPDF(const Vector3& wi, const Vector3& normal, const Vector3& wo) const {
+    return std::abs(dot(wo, normal)) / Math::pi;
   }
 };
 
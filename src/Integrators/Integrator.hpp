@@ -10,6 +10,7 @@
 #include "../Materials/Material.hpp"
 #include "../Math/Point2.hpp"
 #include "../Math/Point3.hpp"
+#include "../Math/RNG.hpp"
 #include "../Math/Random.hpp"
 #include "../Math/Ray.hpp"
 #include "../Math/Vector3.hpp"
@@ -28,19 +29,39 @@ class Integrator {
   ushort samplesPerPixel;
   ushort bounceLimit;
 
+  unsigned threadCount;
+  bool usePackets;
+
   Integrator() = delete;
   Integrator(const Config& config, const Scene& scene, const Camera& camera) :
+      sampler(config),
+      scene(scene),
+      camera(camera),
+      background(config.background),
       imageHeight(config.imageHeight),
       imageWidth(config.imageWidth),
       samplesPerPixel(config.samplesPerPixel),
       bounceLimit(config.bounceLimit),
-      background(config.background),
-      sampler(config),
-      scene(scene),
-      camera(camera) {}
+      threadCount(config.threadCount),
+      usePackets(config.usePackets) {
+    this->scene.commit();
+  }
+
+  // The material of a hit, dispatched statically through the material table of the scene.
+  const MaterialVariant& getMaterial(const SInteraction& interaction) const {
+    return scene.getMaterialVariant(scene.getMaterialId(*interaction.materialPtr));
+  }
 
  public:
-  virtual Color tracePath(const Ray& ray, int bounceLimit) const { return Color(0.5, 0.5, 0.5); };
-  virtual void render(Image& image) const {};
+  virtual Color tracePath(const Ray& ray, int bounceLimit, RNG& rng) const { return Color(0.5, 0.5, 0.5); };
+
+  // Adds samplesPerPixel samples per pixel to image. Every pass draws from its own random streams, so a render can
+  // be split into passes and the passes across runs.
+  virtual void renderPass(Image& image, int pass) const {};
+  void render(Image& image) const { renderPass(image, 0); }
+
+  // State carried from one pass to the next besides the image, for checkpoints.
+  virtual void saveState(std::ostream& out) const {}
+  virtual bool loadState(std::istream& in) { return true; }
 };
 #endif
\ No newline at end of file
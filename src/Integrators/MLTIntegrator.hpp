@@ -1,30 +1,185 @@
 #ifndef MLT_INTEGRATOR_H
 #define MLT_INTEGRATOR_H
 
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../Core/Stopwatch.hpp"
 #include "../PathUtils/MarkovChain.hpp"
 #include "../PathUtils/PrimarySampleSpace.hpp"
 #include "BDPIntegrator.hpp"
 
+// Runs chainCount independent Markov chains over threads. Every chain owns its state, RNG stream and splat film; the
+// films are added to the image in chain order, so the result depends on the chain count but not on the thread count.
 class MLTIntegrator : public BDPTIntegrator {
-  mutable PrimarySampleSpace primarySampleSpace;
+ protected:
   const double largeStepProb = 0.3;
-  const int numRNGsPerEvent = 2;
+  // The scattered direction and a free flight through every medium.
+  const int numRNGsPerEvent = 2 + scene.getMediumCount();
   const int numStatesSubpath = (maxEvents + 2) * numRNGsPerEvent;
   const int numStates = numStatesSubpath * 2;
+  const double pixelStepSize = 2.0 / double(imageHeight + imageWidth);
+  unsigned bootstrapCount;
+  unsigned chainCount;
+
+  // Filled in by the bootstrap before the first pass: the mean contribution b of a large step, and the running sum
+  // of the candidate contributions, which seeds the chains.
+  mutable double normConstant = 0;
+  mutable std::vector<double> bootstrapCDF;
+
+  // A chain and its scratch buffers. The proposal is traced into arena, whose contribution is swapped with the
+  // current one on acceptance, so a step allocates nothing.
+  struct ChainState {
+    MarkovChain current;
+    RNG rng;
+    PathArena arena;
+    ChainState(MarkovChain current, RNG rng, int maxEvents) :
+        current(std::move(current)),
+        rng(rng),
+        arena(maxEvents) {}
+  };
+
+  // Chains carried across passes; set up by the first pass or loaded from a checkpoint.
+  mutable std::vector<ChainState> chains;
+
+  // Candidate i of the bootstrap draws from stream i, chain c from stream bootstrapCount + c.
+  MarkovChain bootstrapSample(int index) const {
+    RNG rng(index);
+    MarkovChain sample(numStates, maxEvents, pixelStepSize, rng);
+    PrimarySampleSpace primarySampleSpace(sample, rng);
+    const Path cameraPath = generateCameraPath(primarySampleSpace);
+    const Path lightPath = generateLightPath(primarySampleSpace, rng);
+    combinePaths(cameraPath, lightPath, sample.pathContribution);
+    return sample;
+  }
+
+  // Calls function(i) for every i in [0, count), handing the indices out in order to up to threadCount threads.
+  template <typename Function>
+  void parallelFor(size_t count, Function function) const {
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+      for (size_t i = next++; i < count; i = next++) function(i);
+    };
+    const unsigned workerCount = std::min<size_t>(std::max(threadCount, 1u), count);
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < workerCount; i++) threads.emplace_back(worker);
+    worker();
+    for (auto& thread : threads) thread.join();
+  }
+
+  // Evaluates the bootstrap candidates in parallel and estimates b from them. The candidates are kept as their
+  // stream indices and contributions, so a chain seed is regenerated on demand instead of stored.
+  void runBootstrap() const {
+    std::cout << "Bootstrapping " << bootstrapCount << " paths" << std::endl;
+    Stopwatch stopwatch;
+    stopwatch.start();
+
+    std::vector<double> contributions(bootstrapCount);
+    parallelFor(bootstrapCount,
+                [&](size_t i) { contributions[i] = bootstrapSample(i).pathContribution.scalarContrib; });
+
+    double sum = 0;
+    bootstrapCDF.resize(bootstrapCount);
+    for (unsigned i = 0; i < bootstrapCount; i++) bootstrapCDF[i] = sum += contributions[i];
+    normConstant = sum / bootstrapCount;
+
+    double variance = 0;
+    for (const auto contribution : contributions) variance += std::pow(contribution - normConstant, 2);
+    variance /= std::max(bootstrapCount - 1, 1u);
+
+    stopwatch.stop();
+    std::cout << "Normalization constant estimated: " << normConstant << " (variance " << variance
+              << ", standard error " << std::sqrt(variance / bootstrapCount) << ")" << std::endl;
+    stopwatch.printTime();
+  }
+
+  // Starts every chain from a bootstrap candidate picked in proportion to its contribution, stratified over the
+  // chains so that they rarely share a starting point.
+  void initializeChains() const {
+    const double sum = bootstrapCDF.back();
+    RNG rng(bootstrapCount + chainCount);
+    chains.clear();
+    chains.reserve(chainCount);
+    for (unsigned c = 0; c < chainCount; c++) {
+      unsigned index = c % bootstrapCount;
+      if (sum > 0) {
+        const double u = (c + Random::fraction(rng)) / chainCount * sum;
+        index = std::min<size_t>(std::upper_bound(bootstrapCDF.begin(), bootstrapCDF.end(), u) - bootstrapCDF.begin(),
+                                 bootstrapCount - 1);
+      }
+      chains.emplace_back(bootstrapSample(index), RNG(bootstrapCount + c), maxEvents);
+    }
+  }
+
+  // Advances one chain by mutationCount mutations, splatting into film. The proposal mutates the chain in place as
+  // its path reads the samples and is undone on rejection. progress(count) is called every imageWidth mutations.
+  template <typename Progress>
+  void runChain(ChainState& chain, size_t mutationCount, Image& film, Progress& progress) const {
+    MarkovChain& current = chain.current;
+    RNG& rng = chain.rng;
+    PathArena& arena = chain.arena;
+    PathContribution& proposal = arena.contribution;
+
+    for (size_t m = 0; m < mutationCount; m++) {
+      // sample the path
+      const bool isLargeStep = Random::fraction(rng) <= largeStepProb;
+      const double isLargeStepDone = isLargeStep ? 1.0 : 0.0;
+      current.startIteration(isLargeStep);
+      PrimarySampleSpace primarySampleSpace(current, rng);
+      generateCameraPath(primarySampleSpace, arena.cameraPath);
+      generateLightPath(primarySampleSpace, rng, arena.lightPath);
+      combinePaths(arena.cameraPath, arena.lightPath, proposal);
+
+      double a = 1.0;
+      if (current.pathContribution.scalarContrib > 0.0)
+        a = std::fmax(std::fmin(1.0, proposal.scalarContrib / current.pathContribution.scalarContrib), 0.0);
+
+      // accumulate samples
+      if (proposal.scalarContrib > 0.0) {
+        auto scale = (a + isLargeStepDone);
+        scale /= (proposal.scalarContrib / normConstant + largeStepProb);
+        proposal.accumulatePathContribution(scale, film);
+      }
+
+      //  It is worth using also the rejected samples since they also provide illumination information.
+      if (current.pathContribution.scalarContrib > 0.0) {
+        auto scale = (1.0 - a) / (current.pathContribution.scalarContrib / normConstant + largeStepProb);
+        current.pathContribution.accumulatePathContribution(scale, film);
+      }
+      // update the chain
+      if (Random::fraction(rng) <= a) {
+        current.accept();
+        std::swap(current.pathContribution, proposal);
+      } else {
+        current.reject();
+      }
+
+      if ((m + 1) % imageWidth == 0) progress(imageWidth);
+    }
+    progress(mutationCount % imageWidth);
+  }
 
  public:
   MLTIntegrator(const Config& config, const Scene& scene, const Camera& camera) :
-      BDPTIntegrator(config, scene, camera) {}
+      BDPTIntegrator(config, scene, camera),
+      bootstrapCount(std::max(config.bootstrapCount, 1u)),
+      chainCount(std::max(config.chainCount > 0 ? config.chainCount : config.threadCount, 1u)) {}
 
-  void tracePath(const Ray& ray, int bounceLimit, Path& path) const {
+  void tracePath(const Ray& ray, int bounceLimit, Path& path, PrimarySampleSpace& primarySampleSpace) const {
     if (bounceLimit <= 0) return;
     SurfaceInteraction interaction;
 
-    // If a ray does not hit anything in the scene, return background color
-    if (!scene.intersect(ray, 0.001, Math::infinity, interaction)) return;
+    // A surface, or a medium scattering the ray before it; the free flights read primary samples too.
+    const bool hit = scene.intersect(ray, 0.001, Math::infinity, interaction);
+    const auto nextRandom = [&primarySampleSpace]() { return primarySampleSpace[primarySampleSpace.offset]; };
+    if (!scene.scatterInMedia(ray, 0.001, hit ? interaction.t : Math::infinity, nextRandom, interaction) && !hit)
+      return;
 
     // set path data
-    path.add(Vertex(interaction));
+    path.add(Vertex(interaction, scene.getMaterialId(*interaction.materialPtr)));
 
     const double random1 = primarySampleSpace[primarySampleSpace.offset];
     const double random2 = primarySampleSpace[primarySampleSpace.offset];
@@ -32,97 +187,126 @@ class MLTIntegrator : public BDPTIntegrator {
 
     Ray scattered;
     Color attenuation;
-    if (interaction.materialPtr->scatter(ray, interaction, attenuation, scattered, scatterDir)) {
-      tracePath(scattered, bounceLimit - 1, path);
+    if (getMaterial(interaction).scatter(ray, interaction, attenuation, scattered, scatterDir)) {
+      tracePath(scattered, bounceLimit - 1, path, primarySampleSpace);
     }
   }
 
-  Path generateCameraPath() const {
+  Path generateCameraPath(PrimarySampleSpace& primarySampleSpace) const {
     Path path(maxEvents);
+    generateCameraPath(primarySampleSpace, path);
+    return path;
+  }
+
+  // Traces into path, replacing its vertices.
+  void generateCameraPath(PrimarySampleSpace& primarySampleSpace, Path& path) const {
+    path.clear();
     primarySampleSpace.offset = 0;
     const double random1 = primarySampleSpace[primarySampleSpace.offset];
     const double random2 = primarySampleSpace[primarySampleSpace.offset];
     Ray ray = camera.getSample(imageHeight, imageWidth, random1, random2);
     path.add(Vertex(ray.origin, camera.getW()));
-    tracePath(ray, bounceLimit, path);
-    return path;
+    tracePath(ray, bounceLimit, path, primarySampleSpace);
+    cacheDensities(path, false);
   }
 
-  Path generateCameraPath(ushort pixelX, ushort pixelY) const {
+  Path generateCameraPath(ushort pixelX, ushort pixelY, PrimarySampleSpace& primarySampleSpace, RNG& rng) const {
     Path path(maxEvents);
     primarySampleSpace.offset = 0;
 
     const double random1 = primarySampleSpace[primarySampleSpace.offset];
     const double random2 = primarySampleSpace[primarySampleSpace.offset];
-    Ray ray = camera.getRay(sampler.getRandomSample(pixelX, pixelY, random1, random2));
+    Ray ray = camera.getRay(sampler.getRandomSample(pixelX, pixelY, random1, random2), rng);
 
     path.add(Vertex(ray.origin, camera.getW()));
-    tracePath(ray, bounceLimit, path);
+    tracePath(ray, bounceLimit, path, primarySampleSpace);
+    cacheDensities(path, false);
     return path;
   }
 
-  Path generateLightPath() const {
+  Path generateLightPath(PrimarySampleSpace& primarySampleSpace, RNG& rng) const {
     Path path(maxEvents);
-    auto randomLight = scene.getRandomLight();
-    auto lightMaterial = scene.getRandomLight()->getMaterial();
+    generateLightPath(primarySampleSpace, rng, path);
+    return path;
+  }
+
+  // Traces into path, replacing its vertices.
+  void generateLightPath(PrimarySampleSpace& primarySampleSpace, RNG& rng, Path& path) const {
+    path.clear();
+    auto randomLight = scene.getRandomLight(rng);
 
     primarySampleSpace.offset = numStatesSubpath;
 
     Ray ray = randomLight->sampleDirection(
         primarySampleSpace[primarySampleSpace.offset], primarySampleSpace[primarySampleSpace.offset],
         primarySampleSpace[primarySampleSpace.offset], primarySampleSpace[primarySampleSpace.offset]);
-    path.add(Vertex(ray.origin, ray.direction, lightMaterial));
-    tracePath(ray, bounceLimit, path);
-    return path;
+    const Material& lightMaterial = *randomLight->getMaterial();
+    path.add(Vertex(ray.origin, ray.direction, lightMaterial, scene.getMaterialId(lightMaterial)));
+    tracePath(ray, bounceLimit, path, primarySampleSpace);
+    cacheDensities(path, true);
   }
 
-  void render(Image& image) const override {
-    // initialize the Markov chain
-    MarkovChain current(numStates, maxEvents);
-    MarkovChain proposal(numStates, maxEvents);
-    primarySampleSpace = PrimarySampleSpace(current);
-
-    // Draw a candidate theta* from a proposal distribution q(theta*|theta_i-1)
-    current.pathContribution = combinePaths(generateCameraPath(), generateLightPath());
-
-    for (int j = imageHeight - 1; j >= 0; --j) {
-      std::cout << "\rScanlines remaining: " << j << "  " << std::flush;
-      for (int i = 0; i < imageWidth; ++i) {
-        for (int s = 0; s < samplesPerPixel; ++s) {
-          // sample the path
-          double isLargeStepDone;
-          if (Random::fraction() <= largeStepProb) {
-            proposal = current.largeStep();
-            isLargeStepDone = 1.0;
-          } else {
-            proposal = current.mutate(imageHeight, imageWidth);
-            isLargeStepDone = 0.0;
-          }
-          primarySampleSpace = PrimarySampleSpace(proposal);
-          proposal.pathContribution = combinePaths(generateCameraPath(), generateLightPath());
-
-          double a = 1.0;
-          if (current.pathContribution.scalarContrib > 0.0)
-            a = std::fmax(
-                std::fmin(1.0, proposal.pathContribution.scalarContrib / current.pathContribution.scalarContrib), 0.0);
-
-          // accumulate samples
-          if (proposal.pathContribution.scalarContrib > 0.0) {
-            auto scale = (a + isLargeStepDone);
-            scale /= (proposal.pathContribution.scalarContrib / normConstant + largeStepProb);
-            proposal.pathContribution.accumulatePathContribution(scale, image);
-          }
-
-          //  It is worth using also the rejected samples since they also provide illumination information.
-          if (current.pathContribution.scalarContrib > 0.0) {
-            auto scale = (1.0 - a) / (current.pathContribution.scalarContrib / normConstant + largeStepProb);
-            current.pathContribution.accumulatePathContribution(scale, image);
-          }
-          // update the chain
-          if (Random::fraction() <= a) current = proposal;
-        }
-      }
+  // A pass makes imageHeight * imageWidth * samplesPerPixel mutations, split evenly over the chains.
+  void renderPass(Image& image, int pass) const override {
+    if (chains.empty()) {
+      runBootstrap();
+      initializeChains();
+    }
+
+    const size_t totalMutations = size_t(imageHeight) * imageWidth * samplesPerPixel;
+    std::vector<Image> films(chainCount, Image(imageHeight, imageWidth));
+    std::atomic<size_t> mutationsDone(0);
+    std::mutex outputMutex;
+
+    // Prints whenever the pass crosses another percent.
+    auto reportProgress = [&](size_t count) {
+      const size_t done = mutationsDone.fetch_add(count) + count;
+      if (100 * (done - count) / totalMutations == 100 * done / totalMutations) return;
+      std::lock_guard<std::mutex> lock(outputMutex);
+      std::cout << "\rMutations done: " << 100 * done / totalMutations << "%  " << std::flush;
+    };
+    Stopwatch stopwatch;
+    stopwatch.start();
+    parallelFor(chainCount, [&](size_t c) {
+      const size_t mutationCount = totalMutations / chainCount + (c < totalMutations % chainCount);
+      runChain(chains[c], mutationCount, films[c], reportProgress);
+    });
+    stopwatch.stop();
+    std::cout << "\rMutations done: 100%  (" << totalMutations / stopwatch.getElapsedSeconds() << " mutations/s)"
+              << std::flush;
+
+    for (const auto& film : films) image += film;
+  }
+
+  void saveState(std::ostream& out) const override {
+    Serialization::write<uint32_t>(out, chains.size());
+    Serialization::write(out, normConstant);
+    for (const auto& chain : chains) {
+      Serialization::write(out, chain.rng.getState());
+      Serialization::write(out, chain.rng.getIncrement());
+      chain.current.save(out);
+    }
+  }
+
+  // An empty state means no pass has run yet; otherwise the chain count has to match. The bootstrap is not rerun,
+  // b comes from the checkpoint.
+  bool loadState(std::istream& in) override {
+    uint32_t count;
+    if (!Serialization::read(in, count) || !Serialization::read(in, normConstant)) return false;
+    if (count != 0 && count != chainCount) {
+      std::cerr << "ERROR: Checkpoint holds " << count << " chains, " << chainCount << " requested." << std::endl;
+      return false;
+    }
+    chains.clear();
+    RNG unused;
+    for (uint32_t c = 0; c < count; c++) {
+      uint64_t state, increment;
+      if (!Serialization::read(in, state) || !Serialization::read(in, increment)) return false;
+      chains.emplace_back(MarkovChain(numStates, maxEvents, pixelStepSize, unused), RNG(), maxEvents);
+      chains.back().rng.setState(state, increment);
+      if (!chains.back().current.load(in)) return false;
     }
+    return true;
   }
 };
 
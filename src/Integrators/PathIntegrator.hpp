@@ -1,44 +1,216 @@
 #ifndef PATH_INTEGRATOR_HPP
 #define PATH_INTEGRATOR_HPP
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "../Core/TileScheduler.hpp"
 #include "Integrator.hpp"
 
+// Unidirectional path tracer. A path is followed iteratively with its throughput; after rouletteDepth bounces Russian
+// roulette ends it with a probability that keeps the estimate unbiased. At diffuse hits a point on the lights is
+// sampled as well (next event estimation) and weighted against hitting the light through the BSDF with the same MIS
+// heuristic as BDPT.
 class PathIntegrator : public Integrator {
+ private:
+  int rouletteDepth;
+  double misPower;
+
+  // Lights are picked in proportion to their area, so every point on them has the area density 1 / lightArea. Empty
+  // if light sampling is off or some light cannot be sampled (samplePoint and getArea are only implemented by the
+  // rectangles).
+  std::vector<const GeoObject*> lights;
+  std::vector<double> lightCDF;
+  double lightArea = 0;
+
+  void buildLightDistribution() {
+    for (const auto& light : scene.getLights()) {
+      if (light->getArea() <= 0) {
+        lights.clear();
+        lightCDF.clear();
+        lightArea = 0;
+        return;
+      }
+      lightArea += light->getArea();
+      lights.push_back(light.get());
+      lightCDF.push_back(lightArea);
+    }
+  }
+
+  bool samplesLights() const { return !lights.empty(); }
+
+  // Only top level emitters are sampled; one inside a transform, BVH or instance is found by BSDF sampling alone.
+  bool isSampledLight(const GeoObject* object) const {
+    return std::find(lights.begin(), lights.end(), object) != lights.end();
+  }
+
+  double misWeight(double pdf, double otherPDF) const {
+    const double a = std::pow(pdf, misPower);
+    const double b = std::pow(otherPDF, misPower);
+    return a / (a + b);
+  }
+
+  // Solid angle density of reaching the light point of interaction from origin by light sampling.
+  double lightPDF(const Point3& origin, const SInteraction& interaction, const Vector3& direction) const {
+    const double cosLight = std::abs(dot(interaction.normal, direction));
+    if (cosLight <= 0) return 0;
+    return (interaction.point - origin).magnitudeSquared() / (cosLight * lightArea);
+  }
+
+  // Light reaching a diffuse hit directly from a sampled light point, weighted against BSDF sampling. Lights emit on
+  // both sides, as when they are hit by a scattered ray.
+  Color sampleLight(const Ray& ray, const SInteraction& interaction, const MaterialVariant& material,
+                    RNG& rng) const {
+    const double u = Random::fraction(rng) * lightArea;
+    const size_t index = std::min<size_t>(std::upper_bound(lightCDF.begin(), lightCDF.end(), u) - lightCDF.begin(),
+                                          lights.size() - 1);
+    const Point3 lightPoint = lights[index]->samplePoint(rng);
+
+    Vector3 direction = lightPoint - interaction.point;
+    const double distance = direction.magnitude();
+    direction = direction / distance;
+    const double cosSurface = dot(interaction.normal, direction);
+    if (cosSurface <= 0) return Color(0, 0, 0);
+
+    // The closest hit towards the point is the sampled light itself unless something blocks it, another emitter
+    // included; it also supplies the normal and texture coordinates there. Media between them dim it by their
+    // transmittance.
+    SInteraction lightHit;
+    const Ray shadowRay(interaction.point, direction, ray.getTime());
+    if (!scene.intersect(shadowRay, 0.001, distance * (1 + 1e-4), lightHit)) return Color(0, 0, 0);
+    if (lightHit.t < distance * (1 - 1e-4) || lightHit.objectPtr != lights[index]) return Color(0, 0, 0);
+    const double transmittance = scene.transmittance(shadowRay, 0.001, lightHit.t);
+    if (transmittance <= 0) return Color(0, 0, 0);
+
+    const double pdfLight = lightPDF(interaction.point, lightHit, direction);
+    if (pdfLight <= 0) return Color(0, 0, 0);
+    const Vector3 incoming = -ray.direction.normalized();
+    const double pdfBSDF = material.pdf(incoming, interaction.normal, direction);
+    const Color reflectance = material.getColor(interaction.uv, interaction.point) *
+                              material.brdf(incoming, interaction.normal, direction);
+    const Color emission = getMaterial(lightHit).emit(lightHit.uv, lightHit.point);
+    return reflectance * emission * (transmittance * cosSurface * misWeight(pdfLight, pdfBSDF) / pdfLight);
+  }
+
  public:
-  PathIntegrator(const Config config, const Scene& scene, const Camera& camera) : Integrator(config, scene, camera) {}
+  PathIntegrator(const Config config, const Scene& scene, const Camera& camera) :
+      Integrator(config, scene, camera),
+      rouletteDepth(config.rouletteDepth),
+      misPower(config.misPower) {
+    if (config.nextEventEstimation) buildLightDistribution();
+  }
 
-  Color tracePath(const Ray& ray, int bounceLimit) const override {
+  Color tracePath(const Ray& ray, int bounceLimit, RNG& rng) const override {
     SInteraction interaction;
     // If a ray exceeds the bounce limit, return black.
     if (bounceLimit <= 0) return Color(0, 0, 0);
 
     // If a ray does not hit anything in the scene, return background color
-    if (!scene.intersect(ray, 0.001, Math::infinity, interaction)) return background;
+    if (!scene.intersect(ray, 0.001, Math::infinity, interaction, rng)) return background;
 
-    Ray scattered;
-    Color attenuation;
-    Color emission = interaction.materialPtr->emit(interaction.uv, interaction.point);
+    return shade(ray, interaction, bounceLimit, rng);
+  }
+
+  // Radiance leaving the first hit of ray towards its origin. The path has at most bounceLimit hits.
+  Color shade(Ray ray, SInteraction interaction, int bounceLimit, RNG& rng) const {
+    Color radiance(0, 0, 0);
+    Color throughput(1, 1, 1);
+    // Solid angle density of the last scatter if light sampling could have found the same light, else 0.
+    double scatterPDF = 0;
+
+    for (int depth = 0;; depth++) {
+      const MaterialVariant& material = getMaterial(interaction);
+      if (interaction.materialPtr->isEmissive()) {
+        double weight = 1;
+        if (scatterPDF > 0 && isSampledLight(interaction.objectPtr)) {
+          const Vector3 direction = ray.direction.normalized();
+          weight = misWeight(scatterPDF, lightPDF(ray.origin, interaction, direction));
+        }
+        radiance += throughput * material.emit(interaction.uv, interaction.point) * weight;
+      }
+      if (depth + 1 >= bounceLimit) break;
 
-    // If a ray hits a light, return the light's emission color.
-    if (!interaction.materialPtr->scatter(ray, interaction, attenuation, scattered)) return emission;
+      const bool sampleLights = samplesLights() && interaction.materialPtr->isDiffuse();
+      if (sampleLights) radiance += throughput * sampleLight(ray, interaction, material, rng);
 
-    // If a ray hits any other material, scatter by spawning a new ray in a recursive way.
-    return emission + attenuation * tracePath(scattered, bounceLimit - 1);
+      Ray scattered;
+      Color attenuation;
+      if (!material.scatter(ray, interaction, attenuation, scattered, rng)) break;
+      scatterPDF = 0;
+      if (sampleLights) {
+        const Vector3 incoming = -ray.direction.normalized();
+        scatterPDF = material.pdf(incoming, interaction.normal, scattered.direction.normalized());
+      }
+      throughput *= attenuation;
+
+      if (rouletteDepth > 0 && depth + 1 >= rouletteDepth) {
+        const double survival = std::fmin(throughput.maxComponent(), 0.95);
+        if (Random::fraction(rng) >= survival) break;
+        throughput = throughput / survival;
+      }
+
+      ray = scattered;
+      if (!scene.intersect(ray, 0.001, Math::infinity, interaction, rng)) {
+        radiance += throughput * background;
+        break;
+      }
+    }
+    return radiance;
   }
 
-  void render(Image& image) const override {
-    Ray ray;
-    for (int j = imageHeight - 1; j >= 0; --j) {
-      std::cout << "\rScanlines remaining: " << j << " " << std::flush;
-      for (int i = 0; i < imageWidth; ++i) {
-        Color pixelColor(0, 0, 0);
-        for (int s = 0; s < samplesPerPixel; ++s) {
-          ray = camera.getRay(sampler.getRandomSample(i, j));
-          pixelColor += tracePath(ray, bounceLimit);
-        }
-        image[(imageHeight - 1 - j) * imageWidth + i] = pixelColor;
+  // Traces the samples of one pixel four at a time: the camera rays of a pixel are nearly identical, so they share
+  // almost every BVH node. Only the first hit is found as a packet, the rest of each path is traced on its own.
+  Color tracePixelPackets(size_t i, size_t j, RNG& rng) const {
+    Color pixelColor(0, 0, 0);
+    if (bounceLimit <= 0) return pixelColor;
+
+    for (int first = 0; first < samplesPerPixel; first += RayPacket::size) {
+      const int laneCount = std::min<int>(RayPacket::size, samplesPerPixel - first);
+      RayPacket packet;
+      for (int lane = 0; lane < laneCount; lane++)
+        packet.set(lane, camera.getRay(sampler.getRandomSample(i, j, rng), rng));
+
+      Real tMax[RayPacket::size] = {Math::realInfinity, Math::realInfinity, Math::realInfinity, Math::realInfinity};
+      SInteraction interactions[RayPacket::size];
+      const int hitMask = scene.intersectPacket(packet, packet.activeMask, 0.001, tMax, interactions);
+
+      // Media are sampled lane by lane, up to the surface hit if there is one.
+      const auto nextRandom = [&rng]() { return Random::fraction(rng); };
+      for (int lane = 0; lane < laneCount; lane++) {
+        const Ray& ray = packet.rays[lane];
+        const bool scattered = scene.scatterInMedia(ray, 0.001, tMax[lane], nextRandom, interactions[lane]);
+        if (scattered || RayPacket::isSet(hitMask, lane))
+          pixelColor += shade(ray, interactions[lane], bounceLimit, rng);
+        else
+          pixelColor += background;
       }
     }
+    return pixelColor;
+  }
+
+  void renderPass(Image& image, int pass) const override {
+    TileScheduler scheduler(imageHeight, imageWidth, threadCount);
+    scheduler.run([this, &image, pass](const Tile& tile, unsigned threadIndex) {
+      Ray ray;
+      for (size_t j = tile.y0; j < tile.y1; ++j) {
+        for (size_t i = tile.x0; i < tile.x1; ++i) {
+          // Every pixel owns its stream, so the result does not depend on which thread renders the tile.
+          RNG rng = Random::pixelStream(j * imageWidth + i, pass);
+          Color pixelColor(0, 0, 0);
+          if (usePackets) {
+            pixelColor = tracePixelPackets(i, j, rng);
+          } else {
+            for (int s = 0; s < samplesPerPixel; ++s) {
+              ray = camera.getRay(sampler.getRandomSample(i, j, rng), rng);
+              pixelColor += tracePath(ray, bounceLimit, rng);
+            }
+          }
+          // Tiles are disjoint, so every pixel is written by exactly one thread.
+          image[(imageHeight - 1 - j) * imageWidth + i] += pixelColor;
+        }
+      }
+    });
   }
 };
 #endif
\ No newline at end of file
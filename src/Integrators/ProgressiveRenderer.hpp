@@ -0,0 +1,126 @@
+#ifndef PROGRESSIVE_RENDERER_HPP
+#define PROGRESSIVE_RENDERER_HPP
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../Core/Configuration.hpp"
+#include "../Core/Image.hpp"
+#include "../Core/Serialization.hpp"
+#include "../Core/Stopwatch.hpp"
+#include "Integrator.hpp"
+
+// Renders config.passCount passes of samplesPerPixel samples each into one accumulated image. With a checkpoint
+// interval it saves the image and the integrator state every so many seconds and after the last pass; resume()
+// restores such a checkpoint so the render continues with the next pass and converges to the same image.
+class ProgressiveRenderer {
+ private:
+  static constexpr uint32_t magic = 0x4B435452;  // "RTCK"
+  static constexpr uint32_t version = 4;
+
+  Integrator& integrator;
+  const Config& config;
+  int passesDone = 0;
+
+ public:
+  ProgressiveRenderer(Integrator& integrator, const Config& config) : integrator(integrator), config(config) {}
+
+  int getPassesDone() const { return passesDone; }
+
+  void render(Image& image) {
+    Stopwatch stopwatch;
+    stopwatch.start();
+    int checkpointPasses = passesDone;
+    for (; passesDone < config.passCount; passesDone++) {
+      if (config.passCount > 1) std::cout << "\nPass " << passesDone + 1 << "/" << config.passCount << std::endl;
+      integrator.renderPass(image, passesDone);
+
+      stopwatch.stop();
+      if (config.checkpointInterval > 0 && stopwatch.getElapsedSeconds() >= config.checkpointInterval) {
+        checkpointPasses = passesDone + 1;
+        writeCheckpoint(image, checkpointPasses);
+        stopwatch.start();
+      }
+    }
+    if (config.checkpointInterval > 0 && checkpointPasses != passesDone) writeCheckpoint(image, passesDone);
+  }
+
+  // Written to a temporary file first and renamed, so a killed job never leaves a truncated checkpoint behind.
+  void writeCheckpoint(const Image& image, int passes) const {
+    const std::string temporaryFile = config.checkpointFile + ".tmp";
+    {
+      std::ofstream out(temporaryFile, std::ios::binary);
+      Serialization::write(out, magic);
+      Serialization::write(out, version);
+      Serialization::write<uint32_t>(out, image.getWidth());
+      Serialization::write<uint32_t>(out, image.getHeight());
+      Serialization::write<uint32_t>(out, config.samplesPerPixel);
+      Serialization::write<uint32_t>(out, config.bounceLimit);
+      Serialization::writeString(out, config.integratorName);
+      Serialization::write<uint32_t>(out, passes);
+
+      const size_t pixelCount = image.getWidth() * image.getHeight();
+      std::vector<double> radiance(3 * pixelCount);
+      for (size_t i = 0; i < pixelCount; i++) {
+        radiance[3 * i] = image[i].red;
+        radiance[3 * i + 1] = image[i].green;
+        radiance[3 * i + 2] = image[i].blue;
+      }
+      out.write(reinterpret_cast<const char*>(radiance.data()), radiance.size() * sizeof(double));
+      integrator.saveState(out);
+      if (!out) {
+        std::cerr << "ERROR: Could not write checkpoint '" << temporaryFile << "'." << std::endl;
+        return;
+      }
+    }
+    std::rename(temporaryFile.c_str(), config.checkpointFile.c_str());
+    std::cout << "\nCheckpoint written after " << passes << " passes: " << config.checkpointFile << std::endl;
+  }
+
+  // Loads the image and integrator state from a checkpoint made with the same settings.
+  bool resume(Image& image, const std::string& fileName) {
+    std::ifstream in(fileName, std::ios::binary);
+    uint32_t fileMagic, fileVersion, width, height, samplesPerPixel, bounceLimit, passes;
+    std::string integratorName;
+    if (!in || !Serialization::read(in, fileMagic) || fileMagic != magic || !Serialization::read(in, fileVersion) ||
+        fileVersion != version) {
+      std::cerr << "ERROR: '" << fileName << "' is not a checkpoint." << std::endl;
+      return false;
+    }
+    Serialization::read(in, width);
+    Serialization::read(in, height);
+    Serialization::read(in, samplesPerPixel);
+    Serialization::read(in, bounceLimit);
+    Serialization::readString(in, integratorName);
+    if (!Serialization::read(in, passes) || width != image.getWidth() || height != image.getHeight() ||
+        samplesPerPixel != uint32_t(config.samplesPerPixel) || bounceLimit != uint32_t(config.bounceLimit) ||
+        integratorName != config.integratorName) {
+      std::cerr << "ERROR: Checkpoint '" << fileName << "' was made with different settings (" << integratorName
+                << ", " << samplesPerPixel << " spp, bounce limit " << bounceLimit << ", " << height << "x" << width
+                << ")." << std::endl;
+      return false;
+    }
+
+    const size_t pixelCount = size_t(width) * height;
+    std::vector<double> radiance(3 * pixelCount);
+    in.read(reinterpret_cast<char*>(radiance.data()), radiance.size() * sizeof(double));
+    if (!in) {
+      std::cerr << "ERROR: Checkpoint '" << fileName << "' is truncated." << std::endl;
+      return false;
+    }
+    if (!integrator.loadState(in)) {
+      std::cerr << "ERROR: Checkpoint '" << fileName << "' has no matching integrator state." << std::endl;
+      return false;
+    }
+    for (size_t i = 0; i < pixelCount; i++) image[i] = Color(radiance[3 * i], radiance[3 * i + 1], radiance[3 * i + 2]);
+
+    passesDone = passes;
+    std::cout << "Resumed from " << fileName << " after " << passes << " passes" << std::endl;
+    return true;
+  }
+};
+
+#endif
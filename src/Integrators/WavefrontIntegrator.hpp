@@ -0,0 +1,198 @@
+#ifndef WAVEFRONT_INTEGRATOR_HPP
+#define WAVEFRONT_INTEGRATOR_HPP
+
+#include <vector>
+
+#include "../Core/TileScheduler.hpp"
+#include "../Materials/ShadingBatch.hpp"
+#include "Integrator.hpp"
+
+// Path tracer that advances all paths of a tile one bounce at a time instead of one path to its end. Every bounce
+// intersects all live rays, sorts the hits by material, shades every material as one batch and compacts the paths
+// that scattered into the next wave. The queues are structures of arrays, so every stage streams only the fields it
+// uses. Estimates the same radiance as PathIntegrator from other random numbers.
+class WavefrontIntegrator : public Integrator {
+ private:
+  // Tiles are larger than for the other integrators to make the batches per material worth sorting.
+  static constexpr size_t tileSize = 32;
+
+  // Live paths. pixel indexes the radiance of the tile.
+  struct PathQueue {
+    std::vector<Point3> origins;
+    std::vector<Vector3> directions;
+    std::vector<Real> times;
+    std::vector<Color> throughputs;
+    std::vector<uint32_t> pixels;
+    std::vector<RNG> rngs;
+
+    size_t size() const { return origins.size(); }
+
+    void clear() {
+      origins.clear();
+      directions.clear();
+      times.clear();
+      throughputs.clear();
+      pixels.clear();
+      rngs.clear();
+    }
+
+    void push(const Ray& ray, const Color& throughput, uint32_t pixel, const RNG& rng) {
+      origins.push_back(ray.origin);
+      directions.push_back(ray.direction);
+      times.push_back(ray.getTime());
+      throughputs.push_back(throughput);
+      pixels.push_back(pixel);
+      rngs.push_back(rng);
+    }
+
+    Ray getRay(size_t index) const { return Ray(origins[index], directions[index], times[index]); }
+  };
+
+  // Hits of the current bounce. path indexes the path queue.
+  struct HitQueue {
+    std::vector<Point3> points;
+    std::vector<Vector3> normals;
+    std::vector<UV> uvs;
+    std::vector<uint8_t> frontFaces;
+    std::vector<uint32_t> materialIds;
+    std::vector<uint32_t> paths;
+
+    size_t size() const { return points.size(); }
+
+    void clear() {
+      points.clear();
+      normals.clear();
+      uvs.clear();
+      frontFaces.clear();
+      materialIds.clear();
+      paths.clear();
+    }
+
+    void push(const SInteraction& interaction, uint32_t materialId, uint32_t path) {
+      points.push_back(interaction.point);
+      normals.push_back(interaction.normal);
+      uvs.push_back(interaction.uv);
+      frontFaces.push_back(interaction.frontFace);
+      materialIds.push_back(materialId);
+      paths.push_back(path);
+    }
+
+    // What the shading kernels need of the hit; the material is known from the batch.
+    SInteraction getInteraction(size_t index) const {
+      SInteraction interaction;
+      interaction.point = points[index];
+      interaction.normal = normals[index];
+      interaction.uv = uvs[index];
+      interaction.frontFace = frontFaces[index];
+      return interaction;
+    }
+  };
+
+  // Buffers of one worker, reused across tiles and passes.
+  struct Wavefront {
+    PathQueue paths;
+    PathQueue scattered;
+    HitQueue hits;
+    ShadingBatch batch;
+    std::vector<Color> radiance;
+  };
+
+  void generateCameraRays(const Tile& tile, int pass, Wavefront& wavefront) const {
+    const size_t tileWidth = tile.x1 - tile.x0;
+    wavefront.paths.clear();
+    for (size_t j = tile.y0; j < tile.y1; ++j) {
+      for (size_t i = tile.x0; i < tile.x1; ++i) {
+        const uint32_t pixel = (j - tile.y0) * tileWidth + (i - tile.x0);
+        for (int s = 0; s < samplesPerPixel; ++s) {
+          // Every sample owns its stream, since the samples of a pixel are traced side by side.
+          RNG rng = Random::pixelStream((j * imageWidth + i) * samplesPerPixel + s, pass);
+          const Ray ray = camera.getRay(sampler.getRandomSample(i, j, rng), rng);
+          wavefront.paths.push(ray, Color(1, 1, 1), pixel, rng);
+        }
+      }
+    }
+  }
+
+  // Finds the hits of all live paths; paths that leave the scene take the background and end. With packets on, the
+  // camera rays are traced four at a time, the samples of a pixel being neighbours in the queue. Scattered rays are
+  // too incoherent for packets to pay off.
+  void intersectStage(Wavefront& wavefront, bool cameraRays) const {
+    PathQueue& paths = wavefront.paths;
+    wavefront.hits.clear();
+    if (usePackets && cameraRays) {
+      for (uint32_t first = 0; first < paths.size(); first += RayPacket::size) {
+        const int laneCount = std::min<int>(RayPacket::size, paths.size() - first);
+        RayPacket packet;
+        for (int lane = 0; lane < laneCount; lane++) packet.set(lane, paths.getRay(first + lane));
+
+        Real tMax[RayPacket::size] = {Math::realInfinity, Math::realInfinity, Math::realInfinity, Math::realInfinity};
+        SInteraction interactions[RayPacket::size];
+        const int hitMask = scene.intersectPacket(packet, packet.activeMask, 0.001, tMax, interactions);
+        for (int lane = 0; lane < laneCount; lane++) {
+          const uint32_t p = first + lane;
+          const auto nextRandom = [&paths, p]() { return Random::fraction(paths.rngs[p]); };
+          if (scene.scatterInMedia(packet.rays[lane], 0.001, tMax[lane], nextRandom, interactions[lane]) ||
+              RayPacket::isSet(hitMask, lane))
+            wavefront.hits.push(interactions[lane], scene.getMaterialId(*interactions[lane].materialPtr), p);
+          else
+            wavefront.radiance[paths.pixels[p]] += paths.throughputs[p] * background;
+        }
+      }
+      return;
+    }
+
+    SInteraction interaction;
+    for (uint32_t p = 0; p < paths.size(); p++) {
+      if (scene.intersect(paths.getRay(p), 0.001, Math::infinity, interaction, paths.rngs[p]))
+        wavefront.hits.push(interaction, scene.getMaterialId(*interaction.materialPtr), p);
+      else
+        wavefront.radiance[paths.pixels[p]] += paths.throughputs[p] * background;
+    }
+  }
+
+  // Adds the emission at every hit and queues the paths that scatter, one material at a time.
+  void shadeStage(Wavefront& wavefront) const {
+    PathQueue& paths = wavefront.paths;
+    const HitQueue& hits = wavefront.hits;
+    wavefront.scattered.clear();
+    wavefront.batch.shade(scene.getMaterialVariants(), hits.materialIds, [&](const auto& bsdf, uint32_t h) {
+      const uint32_t p = hits.paths[h];
+      const SInteraction interaction = hits.getInteraction(h);
+      const Color& throughput = paths.throughputs[p];
+      wavefront.radiance[paths.pixels[p]] += throughput * bsdf.emit(interaction.uv, interaction.point);
+
+      Ray scattered;
+      Color attenuation;
+      if (bsdf.scatter(paths.getRay(p), interaction, attenuation, scattered, paths.rngs[p]))
+        wavefront.scattered.push(scattered, throughput * attenuation, paths.pixels[p], paths.rngs[p]);
+    });
+    std::swap(wavefront.paths, wavefront.scattered);
+  }
+
+ public:
+  WavefrontIntegrator(const Config config, const Scene& scene, const Camera& camera) :
+      Integrator(config, scene, camera) {}
+
+  void renderPass(Image& image, int pass) const override {
+    TileScheduler scheduler(imageHeight, imageWidth, threadCount, tileSize);
+    std::vector<Wavefront> wavefronts(scheduler.getThreadCount());
+    scheduler.run([this, &image, pass, &wavefronts](const Tile& tile, unsigned threadIndex) {
+      Wavefront& wavefront = wavefronts[threadIndex];
+      const size_t tileWidth = tile.x1 - tile.x0;
+      wavefront.radiance.assign(tileWidth * (tile.y1 - tile.y0), Color(0, 0, 0));
+
+      generateCameraRays(tile, pass, wavefront);
+      for (int bounce = 0; bounce < bounceLimit && wavefront.paths.size() > 0; bounce++) {
+        intersectStage(wavefront, bounce == 0);
+        shadeStage(wavefront);
+      }
+
+      // Tiles are disjoint, so every pixel is written by exactly one thread.
+      for (size_t j = tile.y0; j < tile.y1; ++j)
+        for (size_t i = tile.x0; i < tile.x1; ++i)
+          image[(imageHeight - 1 - j) * imageWidth + i] +=
+              wavefront.radiance[(j - tile.y0) * tileWidth + (i - tile.x0)];
+    });
+  }
+};
+#endif
@@ -8,25 +8,30 @@
 class DiffuseLight : public Material {
  private:
   std::shared_ptr<Texture> emission;
+  DiffuseLightBSDF bsdf;
 
  public:
-  DiffuseLight(std::shared_ptr<Texture> emission) : emission(emission) {}
-  DiffuseLight(Color color) : emission(std::make_shared<SolidColor>(color)) {}
+  DiffuseLight(std::shared_ptr<Texture> emission) :
+      Material(MaterialFlags::Emissive),
+      emission(emission),
+      bsdf(emission->toVariant()) {}
+  DiffuseLight(Color color) : DiffuseLight(std::make_shared<SolidColor>(color)) {}
 
-  virtual bool scatter(const Ray& in, const SInteraction& interaction, Color& attenuation,
-                       Ray& scattered) const override {
-    return false;
+  virtual bool scatter(const Ray& in, const SInteraction& interaction, Color& attenuation, Ray& scattered,
+                       RNG& rng) const override {
+    return bsdf.scatter(in, interaction, attenuation, scattered, rng);
   }
 
-  virtual Color emit(const UV& uv, const Point3& point) const override { return emission->lookup(uv, point); }
-  virtual Color getColor(const UV& uv, const Point3& point) const override { return emission->lookup(uv, point); }
+  virtual Color emit(const UV& uv, const Point3& point) const override { return bsdf.emit(uv, point); }
+  virtual Color getColor(const UV& uv, const Point3& point) const override { return bsdf.getColor(uv, point); }
 
-  // Lambertian BRDF
-  double brdf(const Vector3& wi, const Vector3& normal, const Vector3& wo) const override { return 1.0 / Math::pi; }
-
-  // Lambertian BRDF
+  double brdf(const Vector3& wi, const Vector3& normal, const Vector3& wo) const override {
+    return bsdf.brdf(wi, normal, wo);
+  }
   double pdf(const Vector3& wi, const Vector3& normal, const Vector3& wo) const override {
-    return std::abs(dot(wo, normal)) / Math::pi;
+    return bsdf.pdf(wi, normal, wo);
   }
+
+  MaterialVariant toVariant() const override { return bsdf; }
 };
 #endif
\ No newline at end of file
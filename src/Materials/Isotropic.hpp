@@ -1,32 +1,31 @@
 #ifndef ISOTROPIC_HPP
 #define ISOTROPIC_HPP
 
-#include "../Math/Random.hpp"
 #include "../Textures/SolidColor.hpp"
 #include "Material.hpp"
 
 class Isotropic : public Material {
  private:
   std::shared_ptr<Texture> albedo;
+  IsotropicBSDF bsdf;
 
  public:
-  Isotropic(Color color) : albedo(std::make_shared<SolidColor>(color)) {}
-  Isotropic(std::shared_ptr<Texture> albedo) : albedo(albedo) {}
+  Isotropic(Color color) : Isotropic(std::make_shared<SolidColor>(color)) {}
+  Isotropic(std::shared_ptr<Texture> albedo) : albedo(albedo), bsdf(albedo->toVariant()) {}
 
-  virtual bool scatter(const Ray& in, const SInteraction& interaction, Color& attenuation,
-                       Ray& scattered) const override {
-    scattered = Ray(interaction.point, Random::vectorInUnitSphere(), in.getTime());
-    attenuation = albedo->lookup(interaction.uv, interaction.point);
-    return true;
+  virtual bool scatter(const Ray& in, const SInteraction& interaction, Color& attenuation, Ray& scattered,
+                       RNG& rng) const override {
+    return bsdf.scatter(in, interaction, attenuation, scattered, rng);
   }
 
-	// Lambertian BRDF
-	double brdf(const Vector3& wi, const Vector3& normal, const Vector3& wo) const override { return 1.0 / Math::pi; }
-	
-	// Lambertian BRDF
+  double brdf(const Vector3& wi, const Vector3& normal, const Vector3& wo) const override {
+    return bsdf.brdf(wi, normal, wo);
+  }
   double pdf(const Vector3& wi, const Vector3& normal, const Vector3& wo) const override {
-    return std::abs(dot(wo, normal)) / Math::pi;
+    return bsdf.pdf(wi, normal, wo);
   }
+
+  MaterialVariant toVariant() const override { return bsdf; }
 };
 
 #endif
\ No newline at end of file
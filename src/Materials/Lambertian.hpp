@@ -1,41 +1,40 @@
 #ifndef LAMBERTIAN_HPP
 #define LAMBERTIAN_HPP
 
-#include "../Math/ONB.hpp"
-#include "../Math/Random.hpp"
 #include "../Textures/SolidColor.hpp"
 #include "Material.hpp"
 
 class Lambertian : public Material {
  private:
   std::shared_ptr<Texture> albedo;
+  LambertianBSDF bsdf;
 
  public:
-  Lambertian(const Color& albedo) : albedo(std::make_shared<SolidColor>(albedo)) {}
-  Lambertian(std::shared_ptr<Texture> albedo) : albedo(albedo) {}
-
-  bool scatter(const Ray& in, const SInteraction& interaction, Color& attenuation, Ray& scattered) const override {
-    ONB orthonormalBasis(interaction.normal);
-    Vector3 scatterDirection = orthonormalBasis.local(Random::cosineDirection());
-    scattered = Ray(interaction.point, scatterDirection, in.getTime());
-    attenuation = albedo->lookup(interaction.uv, interaction.point);
-    return true;
+  Lambertian(const Color& albedo) : Lambertian(std::make_shared<SolidColor>(albedo)) {}
+  Lambertian(std::shared_ptr<Texture> albedo) :
+      Material(MaterialFlags::Diffuse),
+      albedo(albedo),
+      bsdf(albedo->toVariant()) {}
+
+  bool scatter(const Ray& in, const SInteraction& interaction, Color& attenuation, Ray& scattered,
+               RNG& rng) const override {
+    return bsdf.scatter(in, interaction, attenuation, scattered, rng);
   }
 
   bool scatter(const Ray& in, const SInteraction& interaction, Color& attenuation, Ray& scattered,
                Vector3 direction) const override {
-    ONB orthonormalBasis(interaction.normal);
-    Vector3 scatterDirection = orthonormalBasis.local(direction);
-    scattered = Ray(interaction.point, scatterDirection, in.getTime());
-    attenuation = albedo->lookup(interaction.uv, interaction.point);
-    return true;
+    return bsdf.scatter(in, interaction, attenuation, scattered, direction);
   }
 
-  Color getColor(const UV& uv, const Point3& point) const override { return albedo->lookup(uv, point); }
-  double brdf(const Vector3& wi, const Vector3& normal, const Vector3& wo) const override { return 1.0 / Math::pi; }
+  Color getColor(const UV& uv, const Point3& point) const override { return bsdf.getColor(uv, point); }
+  double brdf(const Vector3& wi, const Vector3& normal, const Vector3& wo) const override {
+    return bsdf.brdf(wi, normal, wo);
+  }
   double pdf(const Vector3& wi, const Vector3& normal, const Vector3& wo) const override {
-    return std::abs(dot(wo, normal)) / Math::pi;
+    return bsdf.pdf(wi, normal, wo);
   }
+
+  MaterialVariant toVariant() const override { return bsdf; }
 };
 
 #endif
\ No newline at end of file
@@ -1,13 +1,37 @@
 #ifndef MATERIAL_HPP
 #define MATERIAL_HPP
 
+#include <cstdint>
+
 #include "../Core/SurfaceInteraction.hpp"
+#include "../Math/RNG.hpp"
 #include "../Math/Ray.hpp"
 #include "../Math/Vector3.hpp"
+#include "MaterialVariant.hpp"
+
+// Properties the integrators branch on, so they can ask without RTTI.
+enum class MaterialFlags : uint8_t {
+  None = 0,
+  Emissive = 1 << 0,  // a light source
+  Diffuse = 1 << 1,   // Lambertian reflection
+};
+
+constexpr MaterialFlags operator|(MaterialFlags a, MaterialFlags b) { return MaterialFlags(uint8_t(a) | uint8_t(b)); }
+constexpr MaterialFlags operator&(MaterialFlags a, MaterialFlags b) { return MaterialFlags(uint8_t(a) & uint8_t(b)); }
+constexpr bool hasFlag(MaterialFlags flags, MaterialFlags flag) { return (flags & flag) != MaterialFlags::None; }
 
 class Material {
  public:
-  virtual bool scatter(const Ray& incoming, const SInteraction& iaction, Color& attenuation, Ray& scattered) const = 0;
+  // Fixed by the constructor of the concrete material.
+  const MaterialFlags flags;
+
+  explicit Material(MaterialFlags flags = MaterialFlags::None) : flags(flags) {}
+
+  bool isEmissive() const { return hasFlag(flags, MaterialFlags::Emissive); }
+  bool isDiffuse() const { return hasFlag(flags, MaterialFlags::Diffuse); }
+
+  virtual bool scatter(const Ray& incoming, const SInteraction& iaction, Color& attenuation, Ray& scattered,
+                       RNG& rng) const = 0;
   virtual bool scatter(const Ray& in, const SInteraction& iaction, Color& atten, Ray& scat, const Vector3 dir) const {
     return false;
   }
@@ -15,6 +39,29 @@ class Material {
   virtual Color getColor(const UV& uv, const Point3& point) const { return Color(0, 0, 0); }
   virtual double brdf(const Vector3& wi, const Vector3& normal, const Vector3& wo) const = 0;
   virtual double pdf(const Vector3& wi, const Vector3& n, const Vector3& wo) const = 0;
+
+  // The same material as a value for the statically dispatched shading path. The built-in materials return their
+  // BSDF; any other material is wrapped in an adapter that keeps calling the virtual functions above.
+  virtual MaterialVariant toVariant() const { return MaterialAdapter{this}; }
 };
 
+inline bool MaterialAdapter::scatter(const Ray& incoming, const SInteraction& iaction, Color& attenuation,
+                                     Ray& scattered, RNG& rng) const {
+  return material->scatter(incoming, iaction, attenuation, scattered, rng);
+}
+inline bool MaterialAdapter::scatter(const Ray& in, const SInteraction& iaction, Color& atten, Ray& scat,
+                                     const Vector3 dir) const {
+  return material->scatter(in, iaction, atten, scat, dir);
+}
+inline Color MaterialAdapter::emit(const UV& uv, const Point3& point) const { return material->emit(uv, point); }
+inline Color MaterialAdapter::getColor(const UV& uv, const Point3& point) const {
+  return material->getColor(uv, point);
+}
+inline double MaterialAdapter::brdf(const Vector3& wi, const Vector3& normal, const Vector3& wo) const {
+  return material->brdf(wi, normal, wo);
+}
+inline double MaterialAdapter::pdf(const Vector3& wi, const Vector3& n, const Vector3& wo) const {
+  return material->pdf(wi, n, wo);
+}
+
 #endif
\ No newline at end of file
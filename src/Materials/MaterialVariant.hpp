@@ -0,0 +1,247 @@
+#ifndef MATERIAL_VARIANT_HPP
+#define MATERIAL_VARIANT_HPP
+
+#include <cmath>
+#include <variant>
+
+#include "../Core/SurfaceInteraction.hpp"
+#include "../Math/ONB.hpp"
+#include "../Math/RNG.hpp"
+#include "../Math/Random.hpp"
+#include "../Math/Ray.hpp"
+#include "../Math/Vector3.hpp"
+#include "../Textures/TextureVariant.hpp"
+
+class Material;
+
+// The built-in materials as plain values. MaterialVariant dispatches over them with a switch, so a call on a known
+// alternative can be inlined; the classes derived from Material forward to these, so both paths share one
+// implementation. Each one has the interface of Material.
+
+// What a material without the corresponding behavior returns.
+struct BSDFDefaults {
+  bool scatter(const Ray& in, const SInteraction& iaction, Color& atten, Ray& scat, const Vector3 dir) const {
+    return false;
+  }
+  Color emit(const UV& uv, const Point3& point) const { return Color(0, 0, 0); }
+  Color getColor(const UV& uv, const Point3& point) const { return Color(0, 0, 0); }
+};
+
+struct LambertianBSDF : BSDFDefaults {
+  TextureVariant albedo;
+
+  explicit LambertianBSDF(const TextureVariant& albedo) : albedo(albedo) {}
+
+  bool scatter(const Ray& in, const SInteraction& interaction, Color& attenuation, Ray& scattered, RNG& rng) const {
+    return scatter(in, interaction, attenuation, scattered, Random::cosineDirection(rng));
+  }
+
+  bool scatter(const Ray& in, const SInteraction& interaction, Color& attenuation, Ray& scattered,
+               const Vector3 direction) const {
+    ONB orthonormalBasis(interaction.normal);
+    Vector3 scatterDirection = orthonormalBasis.local(direction);
+    scattered = Ray(interaction.point, scatterDirection, in.getTime());
+    attenuation = albedo.lookup(interaction.uv, interaction.point);
+    return true;
+  }
+
+  Color getColor(const UV& uv, const Point3& point) const { return albedo.lookup(uv, point); }
+  double brdf(const Vector3& wi, const Vector3& normal, const Vector3& wo) const { return 1.0 / Math::pi; }
+  double pdf(const Vector3& wi, const Vector3& normal, const Vector3& wo) const {
+    return std::abs(dot(wo, normal)) / Math::pi;
+  }
+};
+
+struct MetalBSDF : BSDFDefaults {
+  using BSDFDefaults::scatter;
+
+  Color albedo;
+  double fuzz;
+
+  // Dummy variable
+  double glossiness = 25.0;
+
+  MetalBSDF(const Color& albedo, double fuzz) : albedo(albedo), fuzz(fuzz) {}
+
+  bool scatter(const Ray& incoming, const SInteraction& interaction, Color& attenuation, Ray& scattered,
+               RNG& rng) const {
+    const Vector3 incomingDirection = incoming.direction.normalized();
+    const Vector3 reflected = incomingDirection.reflect(interaction.normal);
+    scattered = Ray(interaction.point, reflected + fuzz * Random::vectorInUnitSphere(rng));
+    attenuation = albedo;
+    return (dot(scattered.direction, interaction.normal) > 0);
+  }
+
+  double brdf(const Vector3& wi, const Vector3& n, const Vector3& wo) const {
+    const double won = dot(wo, n);
+    const double win = dot(wi, n);
+    const Vector3 reflected = (-wi).reflect(n);
+    return (glossiness + 2.0) / (2.0 * Math::pi) * pow(std::fmax(dot(reflected, wo), 0.0), glossiness) /
+           std::fmax(std::abs(win), std::abs(won));
+  }
+
+  double pdf(const Vector3& wi, const Vector3& normal, const Vector3& wo) const {
+    const Vector3 reflected = (-wi).reflect(normal);
+    return (glossiness + 1.0) / (2.0 * Math::pi) * std::pow(std::fmax(dot(reflected, wo), 0.0), glossiness);
+  }
+};
+
+struct DielectricBSDF : BSDFDefaults {
+  using BSDFDefaults::scatter;
+
+  double refractiveIndex;
+
+  explicit DielectricBSDF(double refractiveIndex) : refractiveIndex(refractiveIndex) {}
+
+  static double schlickApprox(double cosine, double refractiveRatio) {
+    // r0: reflection coefficient for light incoming parallel to the normal.
+    auto r0 = (1 - refractiveRatio) / (1 + refractiveRatio);
+    r0 *= r0;
+    return r0 + (1 - r0) * std::pow(1 - cosine, 5);
+  }
+
+  bool scatter(const Ray& incoming, const SInteraction& iaction, Color& attenuation, Ray& scattered, RNG& rng) const {
+    attenuation = Color(1.0, 1.0, 1.0);
+
+    double refractiveRatio;
+    if (iaction.frontFace)
+      refractiveRatio = 1.0 / refractiveIndex;
+    else
+      refractiveRatio = refractiveIndex;
+
+    const Vector3 direction = incoming.direction.normalized();
+
+    const double cosTheta = std::fmin(dot(-direction, iaction.normal), 1.0);
+    const double sinTheta = std::sqrt(1.0 - cosTheta * cosTheta);
+    if (refractiveRatio * sinTheta > 1.0) {
+      const Vector3 reflected = direction.reflect(iaction.normal);
+      scattered = Ray(iaction.point, reflected);
+      return true;
+    }
+
+    const double reflectProb = schlickApprox(cosTheta, refractiveRatio);
+    if (Random::fraction(rng) < reflectProb) {
+      const Vector3 reflected = direction.reflect(iaction.normal);
+      scattered = Ray(iaction.point, reflected);
+      return true;
+    }
+
+    const Vector3 refracted = direction.refract(iaction.normal, refractiveRatio);
+    scattered = Ray(iaction.point, refracted);
+    return true;
+  }
+
+  // Dummy BRDF and PDF. TODO
+  double brdf(const Vector3& wi, const Vector3& normal, const Vector3& wo) const { return 1.0; }
+  double pdf(const Vector3& wi, const Vector3& n, const Vector3& wo) const { return 1.0; }
+};
+
+struct DiffuseLightBSDF : BSDFDefaults {
+  using BSDFDefaults::scatter;
+
+  TextureVariant emission;
+
+  explicit DiffuseLightBSDF(const TextureVariant& emission) : emission(emission) {}
+
+  bool scatter(const Ray& in, const SInteraction& interaction, Color& attenuation, Ray& scattered, RNG& rng) const {
+    return false;
+  }
+
+  Color emit(const UV& uv, const Point3& point) const { return emission.lookup(uv, point); }
+  Color getColor(const UV& uv, const Point3& point) const { return emission.lookup(uv, point); }
+
+  // Lambertian BRDF
+  double brdf(const Vector3& wi, const Vector3& normal, const Vector3& wo) const { return 1.0 / Math::pi; }
+  double pdf(const Vector3& wi, const Vector3& normal, const Vector3& wo) const {
+    return std::abs(dot(wo, normal)) / Math::pi;
+  }
+};
+
+struct IsotropicBSDF : BSDFDefaults {
+  using BSDFDefaults::scatter;
+
+  TextureVariant albedo;
+
+  explicit IsotropicBSDF(const TextureVariant& albedo) : albedo(albedo) {}
+
+  bool scatter(const Ray& in, const SInteraction& interaction, Color& attenuation, Ray& scattered, RNG& rng) const {
+    scattered = Ray(interaction.point, Random::vectorInUnitSphere(rng), in.getTime());
+    attenuation = albedo.lookup(interaction.uv, interaction.point);
+    return true;
+  }
+
+  // Lambertian BRDF
+  double brdf(const Vector3& wi, const Vector3& normal, const Vector3& wo) const { return 1.0 / Math::pi; }
+  double pdf(const Vector3& wi, const Vector3& normal, const Vector3& wo) const {
+    return std::abs(dot(wo, normal)) / Math::pi;
+  }
+};
+
+// Calls the virtual interface of a material outside the closed set. The methods are defined in Material.hpp.
+struct MaterialAdapter {
+  const Material* material;
+
+  bool scatter(const Ray& incoming, const SInteraction& iaction, Color& attenuation, Ray& scattered, RNG& rng) const;
+  bool scatter(const Ray& in, const SInteraction& iaction, Color& atten, Ray& scat, const Vector3 dir) const;
+  Color emit(const UV& uv, const Point3& point) const;
+  Color getColor(const UV& uv, const Point3& point) const;
+  double brdf(const Vector3& wi, const Vector3& normal, const Vector3& wo) const;
+  double pdf(const Vector3& wi, const Vector3& n, const Vector3& wo) const;
+};
+
+// A material by value with the interface of Material. visit() hands the concrete alternative to a generic lambda,
+// which lets a caller hoist the dispatch out of a loop over hits that share the material (see ShadingBatch.hpp).
+class MaterialVariant {
+ private:
+  std::variant<LambertianBSDF, MetalBSDF, DielectricBSDF, DiffuseLightBSDF, IsotropicBSDF, MaterialAdapter> bsdf;
+
+ public:
+  MaterialVariant() : bsdf(MaterialAdapter{nullptr}) {}
+  MaterialVariant(const LambertianBSDF& bsdf) : bsdf(bsdf) {}
+  MaterialVariant(const MetalBSDF& bsdf) : bsdf(bsdf) {}
+  MaterialVariant(const DielectricBSDF& bsdf) : bsdf(bsdf) {}
+  MaterialVariant(const DiffuseLightBSDF& bsdf) : bsdf(bsdf) {}
+  MaterialVariant(const IsotropicBSDF& bsdf) : bsdf(bsdf) {}
+  MaterialVariant(const MaterialAdapter& bsdf) : bsdf(bsdf) {}
+
+  // A switch rather than std::visit, which libstdc++ lowers to a table of function pointers the alternatives cannot
+  // be inlined through.
+  template <typename Function>
+  decltype(auto) visit(Function&& function) const {
+    switch (bsdf.index()) {
+      case 0:
+        return function(*std::get_if<0>(&bsdf));
+      case 1:
+        return function(*std::get_if<1>(&bsdf));
+      case 2:
+        return function(*std::get_if<2>(&bsdf));
+      case 3:
+        return function(*std::get_if<3>(&bsdf));
+      case 4:
+        return function(*std::get_if<4>(&bsdf));
+      default:
+        return function(*std::get_if<5>(&bsdf));
+    }
+  }
+
+  bool scatter(const Ray& incoming, const SInteraction& iaction, Color& attenuation, Ray& scattered, RNG& rng) const {
+    return visit([&](const auto& bsdf) { return bsdf.scatter(incoming, iaction, attenuation, scattered, rng); });
+  }
+  bool scatter(const Ray& in, const SInteraction& iaction, Color& atten, Ray& scat, const Vector3 dir) const {
+    return visit([&](const auto& bsdf) { return bsdf.scatter(in, iaction, atten, scat, dir); });
+  }
+  Color emit(const UV& uv, const Point3& point) const {
+    return visit([&](const auto& bsdf) { return bsdf.emit(uv, point); });
+  }
+  Color getColor(const UV& uv, const Point3& point) const {
+    return visit([&](const auto& bsdf) { return bsdf.getColor(uv, point); });
+  }
+  double brdf(const Vector3& wi, const Vector3& normal, const Vector3& wo) const {
+    return visit([&](const auto& bsdf) { return bsdf.brdf(wi, normal, wo); });
+  }
+  double pdf(const Vector3& wi, const Vector3& n, const Vector3& wo) const {
+    return visit([&](const auto& bsdf) { return bsdf.pdf(wi, n, wo); });
+  }
+};
+
+#endif
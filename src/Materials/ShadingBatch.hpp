@@ -0,0 +1,59 @@
+#ifndef SHADING_BATCH_HPP
+#define SHADING_BATCH_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "MaterialVariant.hpp"
+
+// Shades a batch of hits grouped by material: the hits are bucketed by material id, and every bucket is handed to a
+// single MaterialVariant::visit(), so the loop over it is compiled for the concrete BSDF and dispatches once per
+// material instead of once per hit. Material ids are dense (see Scene::buildMaterialTable), so the buckets come from
+// a counting sort. The ids are passed as their own array rather than read out of the hit records, which keeps the
+// sort from streaming the whole batch through the cache twice. The buffers are kept between batches.
+class ShadingBatch {
+ private:
+  std::vector<uint32_t> offsets;
+  std::vector<uint32_t> order;
+
+ public:
+  // Buckets hit indices by material. Stable, so hits of one material keep their relative order.
+  void sort(size_t materialCount, const std::vector<uint32_t>& materialIds) {
+    offsets.assign(materialCount + 1, 0);
+    for (const auto id : materialIds) offsets[id + 1]++;
+    for (size_t m = 0; m < materialCount; m++) offsets[m + 1] += offsets[m];
+
+    // Afterwards offsets[m] is the end of bucket m, which is the start of bucket m + 1; shift back.
+    order.resize(materialIds.size());
+    for (uint32_t i = 0; i < materialIds.size(); i++) order[offsets[materialIds[i]]++] = i;
+    for (size_t m = materialCount; m > 0; m--) offsets[m] = offsets[m - 1];
+    offsets[0] = 0;
+  }
+
+  // Calls function(bsdf, index) for every hit index of the last sort(), bucket by bucket, bsdf being the concrete
+  // alternative of the material of the bucket.
+  template <typename Function>
+  void shadeSorted(const std::vector<MaterialVariant>& materials, Function&& function) const {
+    const uint32_t* indices = order.data();
+    for (size_t m = 0; m + 1 < offsets.size(); m++) {
+      const uint32_t begin = offsets[m];
+      const uint32_t end = offsets[m + 1];
+      if (begin == end) continue;
+      materials[m].visit([&](const auto& bsdf) {
+        for (uint32_t k = begin; k < end; k++) function(bsdf, indices[k]);
+      });
+    }
+  }
+
+  template <typename Function>
+  void shade(const std::vector<MaterialVariant>& materials, const std::vector<uint32_t>& materialIds,
+             Function&& function) {
+    sort(materials.size(), materialIds);
+    shadeSorted(materials, std::forward<Function>(function));
+  }
+
+  // Hit indices grouped by material, as left by the last sort().
+  const std::vector<uint32_t>& getOrder() const { return order; }
+};
+
+#endif
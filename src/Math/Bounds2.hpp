@@ -9,8 +9,8 @@ class Bounds2 {
   Point2 minPoint, maxPoint;
 
   Bounds2() {
-    double minLimit = std::numeric_limits<double>::lowest();
-    double maxLimit = std::numeric_limits<double>::max();
+    Real minLimit = std::numeric_limits<Real>::lowest();
+    Real maxLimit = std::numeric_limits<Real>::max();
     minPoint = Point2(maxLimit, maxLimit);
     maxPoint = Point2(minLimit, minLimit);
   }
@@ -2,8 +2,19 @@
 #define MATH_HPP
 
 #include <cmath>
+#include <limits>
+
+// Scalar type of the geometry: vectors, points, rays, boxes and intersection code. Shading and accumulation stay in
+// double. Define RAY_TRACING_FLOAT for a single precision build.
+#ifdef RAY_TRACING_FLOAT
+using Real = float;
+#else
+using Real = double;
+#endif
+
 namespace Math {
   const double infinity = std::numeric_limits<double>::infinity();
+  const Real realInfinity = std::numeric_limits<Real>::infinity();  // For Real arrays and initializers
   const double pi = 2 * std::acos(0.0);
   const double shadowEpsilon = 0.0001f;
 
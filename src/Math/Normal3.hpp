@@ -8,9 +8,9 @@
 
 class Normal3 {
  public:
-  double x, y, z;
+  Real x, y, z;
   Normal3() {}
-  Normal3(double x, double y, double z) : x(x), y(y), z(z) {}
+  Normal3(Real x, Real y, Real z) : x(x), y(y), z(z) {}
 
   // Copy constructor
   Normal3(const Normal3& other) : x(other.x), y(other.y), z(other.z) {}
@@ -38,19 +38,19 @@ class Normal3 {
 
   bool hasNaNs() const { return std::isnan(x) || std::isnan(y) || std::isnan(z); }
 
-  double magnitude() const { return std::sqrt(magnitudeSquared()); }
-  double magnitudeSquared() const { return x * x + y * y + z * z; }
+  Real magnitude() const { return std::sqrt(magnitudeSquared()); }
+  Real magnitudeSquared() const { return x * x + y * y + z * z; }
 
   void normalize() { *this / magnitude(); }
   Normal3 normalized() const { return Normal3(*this / magnitude()); }
 
   // Member access operators
-  double operator[](int i) const {
+  Real operator[](int i) const {
     if (i == 0) return x;
     if (i == 1) return y;
     return z;
   }
-  double& operator[](int i) {
+  Real& operator[](int i) {
     if (i == 0) return x;
     if (i == 1) return y;
     return z;
@@ -69,25 +69,25 @@ class Normal3 {
     z -= normal.z;
     return *this;
   }
-  Normal3& operator*=(double scalar) {
+  Normal3& operator*=(Real scalar) {
     x *= scalar;
     y *= scalar;
     z *= scalar;
     return *this;
   }
-  Normal3& operator/=(double scalar) {
+  Normal3& operator/=(Real scalar) {
     assert(!hasNaNs());
     return *this *= (1.f / scalar);
   }
 
   // Arithmetic operators
-  Normal3 operator*(double scalar) const { return Normal3(scalar * x, scalar * y, scalar * z); }
+  Normal3 operator*(Real scalar) const { return Normal3(scalar * x, scalar * y, scalar * z); }
   Normal3 operator-() const { return Normal3(-x, -y, -z); }
   Normal3 operator+(const Normal3& n) const { return Normal3(x + n.x, y + n.y, z + n.z); }
   Normal3 operator-(const Normal3& n) const { return Normal3(x - n.x, y - n.y, z - n.z); }
-  Normal3 operator/(double scalar) const {
+  Normal3 operator/(Real scalar) const {
     assert(scalar != 0);
-    double fraction = 1.f / scalar;
+    Real fraction = 1.f / scalar;
     return Normal3(x * fraction, y * fraction, z * fraction);
   }
 
@@ -96,12 +96,12 @@ class Normal3 {
   bool operator!=(const Normal3& normal) const { return x != normal.x || y != normal.y || z != normal.z; }
 
   // Friend functions
-  friend double dot(const Normal3& n, const Vector3& v);
-  friend double dot(const Vector3& v, const Normal3& n);
-  friend double dot(const Normal3& n1, const Normal3& n2);
-  friend double absDot(const Normal3& n, const Vector3& v) { return std::abs(n.x * v.x + n.y * v.y + n.z * v.z); }
-  friend double absDot(const Vector3& v, const Normal3& n) { return std::abs(v.x * n.x + v.y * n.y + v.z * n.z); }
-  friend double absDot(const Normal3& n1, const Normal3& n2) {
+  friend Real dot(const Normal3& n, const Vector3& v);
+  friend Real dot(const Vector3& v, const Normal3& n);
+  friend Real dot(const Normal3& n1, const Normal3& n2);
+  friend Real absDot(const Normal3& n, const Vector3& v) { return std::abs(n.x * v.x + n.y * v.y + n.z * v.z); }
+  friend Real absDot(const Vector3& v, const Normal3& n) { return std::abs(v.x * n.x + v.y * n.y + v.z * n.z); }
+  friend Real absDot(const Normal3& n1, const Normal3& n2) {
     return std::abs(n1.x * n2.x + n1.y * n2.y + n1.z * n2.z);
   }
   friend Normal3 abs(const Normal3& n) { return Normal3(std::abs(n.x), std::abs(n.y), std::abs(n.z)); }
@@ -109,16 +109,16 @@ class Normal3 {
   friend Normal3 faceForward(const Normal3& n1, const Normal3& n2) { return (dot(n1, n2) < 0.f) ? -n1 : n1; }
   friend Vector3 faceForward(const Vector3& v1, const Vector3& v2) { return (dot(v1, v2) < 0.f) ? -v1 : v1; }
   friend Vector3 faceForward(const Vector3& v, const Normal3& n) { return (dot(v, n) < 0.f) ? -v : v; }
-  friend Normal3 operator*(double scalar, const Normal3& n);
+  friend Normal3 operator*(Real scalar, const Normal3& n);
   friend std::ostream& operator<<(std::ostream& os, const Normal3& v) {
     os << "[" << v.x << ", " << v.y << ", " << v.z << "]";
     return os;
   }
 };
 
-Normal3 operator*(double scalar, const Normal3& n) { return Normal3(scalar * n.x, scalar * n.y, scalar * n.z); }
-double dot(const Normal3& n, const Vector3& v) { return n.x * v.x + n.y * v.y + n.z * v.z; }
-double dot(const Vector3& v, const Normal3& n) { return v.x * n.x + v.y * n.y + v.z * n.z; }
-double dot(const Normal3& n1, const Normal3& n2) { return n1.x * n2.x + n1.y * n2.y + n1.z * n2.z; }
+Normal3 operator*(Real scalar, const Normal3& n) { return Normal3(scalar * n.x, scalar * n.y, scalar * n.z); }
+Real dot(const Normal3& n, const Vector3& v) { return n.x * v.x + n.y * v.y + n.z * v.z; }
+Real dot(const Vector3& v, const Normal3& n) { return v.x * n.x + v.y * n.y + v.z * n.z; }
+Real dot(const Normal3& n1, const Normal3& n2) { return n1.x * n2.x + n1.y * n2.y + n1.z * n2.z; }
 
 #endif
\ No newline at end of file
@@ -13,7 +13,7 @@ class OrthonormalBasis {
     u = cross(w, v);
   }
 
-  Vector3 local(double a, double b, double c) const { return a * u + b * v + c * w; }
+  Vector3 local(Real a, Real b, Real c) const { return a * u + b * v + c * w; }
   Vector3 local(const Vector3& a) const { return a.x * u + a.y * v + a.z * w; }
 };
 
@@ -0,0 +1,70 @@
+#ifndef RNG_HPP
+#define RNG_HPP
+
+#include <cstdint>
+
+// PCG32 (O'Neill, "PCG: A Family of Simple Fast Space-Efficient Statistically Good Algorithms for Random Number
+// Generation"). 16 bytes of state, 2^63 selectable streams and O(log n) skip-ahead, so every pixel, sample or chain
+// can own an independent and reproducible stream without any shared state between threads.
+class PCG32 {
+ private:
+  static constexpr uint64_t defaultState = 0x853C49E6748FEA9Bull;
+  static constexpr uint64_t defaultStream = 0xDA3E39CB94B95BDBull;
+  static constexpr uint64_t multiplier = 0x5851F42D4C957F2Dull;
+
+  uint64_t state;
+  uint64_t increment;
+
+ public:
+  PCG32() : state(defaultState), increment(defaultStream) {}
+  PCG32(uint64_t sequenceIndex, uint64_t seed = defaultState) { setSequence(sequenceIndex, seed); }
+
+  // Selects the stream and the starting point within it.
+  void setSequence(uint64_t sequenceIndex, uint64_t seed = defaultState) {
+    state = 0u;
+    increment = (sequenceIndex << 1u) | 1u;
+    nextUInt();
+    state += seed;
+    nextUInt();
+  }
+
+  uint32_t nextUInt() {
+    const uint64_t oldState = state;
+    state = oldState * multiplier + increment;
+    const uint32_t xorShifted = static_cast<uint32_t>(((oldState >> 18u) ^ oldState) >> 27u);
+    const uint32_t rotation = static_cast<uint32_t>(oldState >> 59u);
+    return (xorShifted >> rotation) | (xorShifted << ((~rotation + 1u) & 31));
+  }
+
+  // Uniform double in [0, 1).
+  double nextDouble() { return nextUInt() * 0x1p-32; }
+
+  // Skips delta draws ahead (or back, for negative delta) in O(log delta).
+  void advance(int64_t delta) {
+    uint64_t currentMultiplier = multiplier;
+    uint64_t currentIncrement = increment;
+    uint64_t accumulatedMultiplier = 1u;
+    uint64_t accumulatedIncrement = 0u;
+    uint64_t steps = static_cast<uint64_t>(delta);
+    while (steps > 0) {
+      if (steps & 1) {
+        accumulatedMultiplier *= currentMultiplier;
+        accumulatedIncrement = accumulatedIncrement * currentMultiplier + currentIncrement;
+      }
+      currentIncrement = (currentMultiplier + 1) * currentIncrement;
+      currentMultiplier *= currentMultiplier;
+      steps /= 2;
+    }
+    state = accumulatedMultiplier * state + accumulatedIncrement;
+  }
+
+  uint64_t getState() const { return state; }
+  uint64_t getIncrement() const { return increment; }
+  void setState(uint64_t state, uint64_t increment) {
+    this->state = state;
+    this->increment = increment;
+  }
+};
+
+using RNG = PCG32;
+#endif
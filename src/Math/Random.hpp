@@ -1,54 +1,75 @@
 #ifndef RANDOM_HPP
 #define RANDOM_HPP
 
-#include <random>
+#include <cstdint>
 
 #include "../Math/Point3.hpp"
 #include "../Math/Vector3.hpp"
 #include "Math.hpp"
+#include "RNG.hpp"
 
+// Sampling helpers. Every function has an overload drawing from an explicit RNG stream (used by the integrators) and
+// one drawing from the calling thread's own generator (used for scene construction).
 namespace Random {
-  std::default_random_engine generator;
-  std::uniform_real_distribution<double> distribution(0.0, 1.0);
+  thread_local RNG generator;
+
+  // SplitMix64 finalizer, spreads consecutive keys (e.g. pixel indices) over the whole seed space.
+  inline uint64_t hash(uint64_t key) {
+    key += 0x9E3779B97F4A7C15ull;
+    key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ull;
+    key = (key ^ (key >> 27)) * 0x94D049BB133111EBull;
+    return key ^ (key >> 31);
+  }
+
+  // Stream for a given pixel and pass, independent of which thread renders it.
+  inline RNG pixelStream(uint64_t pixelIndex, uint64_t pass = 0) { return RNG(hash(pixelIndex), hash(pass)); }
+
+  inline double fraction(RNG& rng) { return rng.nextDouble(); }
+  inline double fraction() { return fraction(generator); }
 
-  inline double fraction() { return distribution(generator); }
-  inline double range(double min, double max) { return min + (max - min) * fraction(); }
+  inline double range(RNG& rng, double min, double max) { return min + (max - min) * fraction(rng); }
+  inline double range(double min, double max) { return range(generator, min, max); }
 
   // Returns an integer between [min, max).
-  inline int rangeInt(int min, int max) { return std::floor(range(min, max)); }
+  inline int rangeInt(RNG& rng, int min, int max) { return std::floor(range(rng, min, max)); }
+  inline int rangeInt(int min, int max) { return rangeInt(generator, min, max); }
 
   inline Color color() { return Color(fraction(), fraction(), fraction()); }
   inline Color colorRange(double min, double max) { return Color(range(min, max), range(min, max), range(min, max)); }
 
   inline Vector3 vector() { return Vector3(fraction(), fraction(), fraction()); }
-  inline Vector3 vectorRange(double min, double max) {
-    return Vector3(range(min, max), range(min, max), range(min, max));
+  inline Vector3 vectorRange(RNG& rng, double min, double max) {
+    return Vector3(range(rng, min, max), range(rng, min, max), range(rng, min, max));
   }
+  inline Vector3 vectorRange(double min, double max) { return vectorRange(generator, min, max); }
 
   inline Point3 pointRange(double min, double max) { return Point3(range(min, max), range(min, max), range(min, max)); }
 
-  Vector3 unitVector() {
-    auto angle = range(0, 2 * Math::pi);
-    auto z = range(-1, 1);
+  Vector3 unitVector(RNG& rng) {
+    auto angle = range(rng, 0, 2 * Math::pi);
+    auto z = range(rng, -1, 1);
     auto r = std::sqrt(1 - z * z);
     return Vector3(r * std::cos(angle), r * std::sin(angle), z);
   }
+  Vector3 unitVector() { return unitVector(generator); }
 
-  Vector3 vectorInUnitSphere() {
+  Vector3 vectorInUnitSphere(RNG& rng) {
     while (true) {
-      auto vector = Random::vectorRange(-1, 1);
+      auto vector = Random::vectorRange(rng, -1, 1);
       if (vector.magnitudeSquared() >= 1) continue;
       return vector;
     }
   }
+  Vector3 vectorInUnitSphere() { return vectorInUnitSphere(generator); }
 
-  Vector3 vectorInUnitDisk() {
+  Vector3 vectorInUnitDisk(RNG& rng) {
     while (true) {
-      auto vector = Vector3(range(-1, 1), range(-1, 1), 0);
+      auto vector = Vector3(range(rng, -1, 1), range(rng, -1, 1), 0);
       if (vector.magnitudeSquared() >= 1) continue;
       return vector;
     }
   }
+  Vector3 vectorInUnitDisk() { return vectorInUnitDisk(generator); }
 
   double mapInterval(double value, double min, double max) { return min + (max - min) * value; }
 
@@ -61,26 +82,14 @@ namespace Random {
     }
   }
 
-  Vector3 vectorInHemiSphere(const Vector3& normal) {
-    Vector3 inUnitSphere = vectorInUnitSphere();
+  Vector3 vectorInHemiSphere(RNG& rng, const Vector3& normal) {
+    Vector3 inUnitSphere = vectorInUnitSphere(rng);
     if (dot(inUnitSphere, normal) > 0.0)
       return inUnitSphere;
     else
       return -inUnitSphere;
   }
-
-  // Sample the vector from cosine distribution.
-  inline Vector3 cosineDirection() {
-    auto r1 = fraction();
-    auto r2 = fraction();
-    auto phi = 2 * Math::pi * r1;
-
-    auto x = std::cos(phi) * std::sqrt(r2);
-    auto y = std::sin(phi) * std::sqrt(r2);
-    auto z = std::sqrt(1 - r2);
-
-    return Vector3(x, y, z);
-  }
+  Vector3 vectorInHemiSphere(const Vector3& normal) { return vectorInHemiSphere(generator, normal); }
 
   // Sample the vector from cosine distribution.
   inline Vector3 cosineDirection(const double random1, const double random2) {
@@ -93,6 +102,14 @@ namespace Random {
     return Vector3(x, y, z);
   }
 
+  // Sample the vector from cosine distribution.
+  inline Vector3 cosineDirection(RNG& rng) {
+    const double random1 = fraction(rng);
+    const double random2 = fraction(rng);
+    return cosineDirection(random1, random2);
+  }
+  inline Vector3 cosineDirection() { return cosineDirection(generator); }
+
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -9,11 +9,11 @@ class Ray {
  public:
   Point3 origin;
   Vector3 direction;
-  double tMin, tMax;
-  double time;
+  Real tMin = 0, tMax = Math::realInfinity;
+  Real time;
 
   Ray() {}
-  Ray(const Point3& origin, const Vector3& direction, double time = 0.0) :
+  Ray(const Point3& origin, const Vector3& direction, Real time = 0.0) :
       origin(origin),
       direction(direction),
       time(time) {}
@@ -54,14 +54,14 @@ class Ray {
     return *this;
   }
 
-  Point3 operator()(double t) { return origin + t * direction; }
+  Point3 operator()(Real t) { return origin + t * direction; }
 
   // P(t) = O+ t * d
-  Point3 at(double t) const { return origin + t * direction; }
+  Point3 at(Real t) const { return origin + t * direction; }
   Point3 getOrigin() const { return origin; }
   Vector3 getDirection() const { return direction; }
 
-  double getTime() const { return time; }
+  Real getTime() const { return time; }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,48 @@
+#ifndef RAY_PACKET_HPP
+#define RAY_PACKET_HPP
+
+#include <cstdint>
+#include <type_traits>
+
+#include "Ray.hpp"
+
+// Four rays traced together. Packet queries take a lane mask; lanes outside it are ignored.
+// Origins, directions and inverse directions are also kept as structure of arrays for the SIMD box test.
+struct RayPacket {
+  // Unsigned integer as wide as Real, for lane masks.
+  using RealBits = std::conditional_t<sizeof(Real) == 8, uint64_t, uint32_t>;
+
+  static constexpr int size = 4;
+  static constexpr int fullMask = (1 << size) - 1;
+
+  Ray rays[size];
+  alignas(16) Real origin[3][size];
+  alignas(16) Real direction[3][size];
+  alignas(16) Real inverseDirection[3][size];
+  alignas(16) RealBits negativeMask[3][size];  // all bits set where the direction component is negative
+  int activeMask = 0;
+
+  RayPacket() {
+    for (int a = 0; a < 3; a++) {
+      for (int lane = 0; lane < size; lane++) {
+        origin[a][lane] = direction[a][lane] = inverseDirection[a][lane] = 0;
+        negativeMask[a][lane] = 0;
+      }
+    }
+  }
+
+  void set(int lane, const Ray& ray) {
+    rays[lane] = ray;
+    for (int a = 0; a < 3; a++) {
+      origin[a][lane] = ray.origin[a];
+      direction[a][lane] = ray.direction[a];
+      inverseDirection[a][lane] = 1 / ray.direction[a];
+      negativeMask[a][lane] = inverseDirection[a][lane] < 0 ? ~RealBits(0) : 0;
+    }
+    activeMask |= 1 << lane;
+  }
+
+  static bool isSet(int mask, int lane) { return mask & (1 << lane); }
+};
+
+#endif
@@ -0,0 +1,148 @@
+#ifndef TRANSFORM_HPP
+#define TRANSFORM_HPP
+
+#include <cmath>
+
+#include "Math.hpp"
+#include "Point3.hpp"
+#include "Ray.hpp"
+#include "Vector3.hpp"
+
+// Affine transform kept as the top three rows of its 4x4 matrix, together with those of its inverse, so neither
+// direction needs an inversion at trace time. (a * b) applies b first.
+class Transform {
+ private:
+  Real matrix[3][4];
+  Real inverse[3][4];
+
+  static void setIdentity(Real rows[3][4]) {
+    for (int i = 0; i < 3; i++)
+      for (int j = 0; j < 4; j++) rows[i][j] = i == j ? 1 : 0;
+  }
+
+  // result = a * b, both affine.
+  static void multiply(const Real a[3][4], const Real b[3][4], Real result[3][4]) {
+    for (int i = 0; i < 3; i++) {
+      for (int j = 0; j < 4; j++) {
+        result[i][j] = a[i][0] * b[0][j] + a[i][1] * b[1][j] + a[i][2] * b[2][j];
+        if (j == 3) result[i][j] += a[i][3];
+      }
+    }
+  }
+
+  // Rows times (v, w), w being 1 for points and 0 for vectors.
+  template <typename Result, typename T>
+  static Result applyRows(const Real rows[3][4], const T& v, Real w) {
+    return Result(rows[0][0] * v.x + rows[0][1] * v.y + rows[0][2] * v.z + rows[0][3] * w,
+                  rows[1][0] * v.x + rows[1][1] * v.y + rows[1][2] * v.z + rows[1][3] * w,
+                  rows[2][0] * v.x + rows[2][1] * v.y + rows[2][2] * v.z + rows[2][3] * w);
+  }
+
+  static Transform rotation(int axis, Real degrees) {
+    const Real radians = Math::degreesToRadians(degrees);
+    const Real sinTheta = std::sin(radians);
+    const Real cosTheta = std::cos(radians);
+    // Turns axisA towards axisB.
+    const int axisA = (axis + 1) % 3;
+    const int axisB = (axis + 2) % 3;
+    Transform result;
+    result.matrix[axisA][axisA] = result.matrix[axisB][axisB] = cosTheta;
+    result.matrix[axisA][axisB] = -sinTheta;
+    result.matrix[axisB][axisA] = sinTheta;
+    // Rotations are orthogonal: the inverse is the transpose.
+    result.inverse[axisA][axisA] = result.inverse[axisB][axisB] = cosTheta;
+    result.inverse[axisA][axisB] = sinTheta;
+    result.inverse[axisB][axisA] = -sinTheta;
+    return result;
+  }
+
+ public:
+  Transform() {
+    setIdentity(matrix);
+    setIdentity(inverse);
+  }
+
+  // From the top three rows of an affine matrix, whose 3x3 part has to be invertible.
+  explicit Transform(const Real rows[3][4]) {
+    for (int i = 0; i < 3; i++)
+      for (int j = 0; j < 4; j++) matrix[i][j] = rows[i][j];
+
+    // Inverse of the 3x3 part from its cofactors, then the translation moved back through it.
+    const Real(&a)[3][4] = matrix;
+    const Real cofactors[3][3] = {
+        {a[1][1] * a[2][2] - a[1][2] * a[2][1], a[1][2] * a[2][0] - a[1][0] * a[2][2],
+         a[1][0] * a[2][1] - a[1][1] * a[2][0]},
+        {a[0][2] * a[2][1] - a[0][1] * a[2][2], a[0][0] * a[2][2] - a[0][2] * a[2][0],
+         a[0][1] * a[2][0] - a[0][0] * a[2][1]},
+        {a[0][1] * a[1][2] - a[0][2] * a[1][1], a[0][2] * a[1][0] - a[0][0] * a[1][2],
+         a[0][0] * a[1][1] - a[0][1] * a[1][0]}};
+    const Real inverseDeterminant =
+        1 / (a[0][0] * cofactors[0][0] + a[0][1] * cofactors[0][1] + a[0][2] * cofactors[0][2]);
+    for (int i = 0; i < 3; i++)
+      for (int j = 0; j < 3; j++) inverse[i][j] = cofactors[j][i] * inverseDeterminant;
+    for (int i = 0; i < 3; i++)
+      inverse[i][3] = -(inverse[i][0] * a[0][3] + inverse[i][1] * a[1][3] + inverse[i][2] * a[2][3]);
+  }
+
+  static Transform translation(const Vector3& offset) {
+    Transform result;
+    for (int i = 0; i < 3; i++) {
+      result.matrix[i][3] = offset[i];
+      result.inverse[i][3] = -offset[i];
+    }
+    return result;
+  }
+
+  static Transform scaling(Real x, Real y, Real z) {
+    Transform result;
+    const Real factors[3] = {x, y, z};
+    for (int i = 0; i < 3; i++) {
+      result.matrix[i][i] = factors[i];
+      result.inverse[i][i] = 1 / factors[i];
+    }
+    return result;
+  }
+  static Transform scaling(Real factor) { return scaling(factor, factor, factor); }
+
+  // Counterclockwise seen from the positive side of the axis; rotationY turns the same way as RotateY.
+  static Transform rotationX(Real degrees) { return rotation(0, degrees); }
+  static Transform rotationY(Real degrees) { return rotation(1, degrees); }
+  static Transform rotationZ(Real degrees) { return rotation(2, degrees); }
+
+  Transform operator*(const Transform& other) const {
+    Transform result;
+    multiply(matrix, other.matrix, result.matrix);
+    multiply(other.inverse, inverse, result.inverse);
+    return result;
+  }
+
+  Transform inverted() const {
+    Transform result;
+    for (int i = 0; i < 3; i++) {
+      for (int j = 0; j < 4; j++) {
+        result.matrix[i][j] = inverse[i][j];
+        result.inverse[i][j] = matrix[i][j];
+      }
+    }
+    return result;
+  }
+
+  Point3 applyToPoint(const Point3& point) const { return applyRows<Point3>(matrix, point, 1); }
+  Vector3 applyToVector(const Vector3& vector) const { return applyRows<Vector3>(matrix, vector, 0); }
+  // Normals go through the inverse transpose, which keeps them perpendicular to transformed surfaces. The result is
+  // not normalized.
+  Vector3 applyToNormal(const Vector3& normal) const {
+    return Vector3(inverse[0][0] * normal.x + inverse[1][0] * normal.y + inverse[2][0] * normal.z,
+                   inverse[0][1] * normal.x + inverse[1][1] * normal.y + inverse[2][1] * normal.z,
+                   inverse[0][2] * normal.x + inverse[1][2] * normal.y + inverse[2][2] * normal.z);
+  }
+
+  // The ray in the frame this transform maps from. The direction keeps its scale, so hit distances along the two
+  // rays are the same.
+  Ray applyInverse(const Ray& ray) const {
+    return Ray(applyRows<Point3>(inverse, ray.origin, 1), applyRows<Vector3>(inverse, ray.direction, 0),
+               ray.getTime());
+  }
+};
+
+#endif
@@ -4,14 +4,16 @@
 #include <cmath>
 #include <iostream>
 
+#include "Math.hpp"
+
 class Point2;
 class Point3;
 
 class Vector2 {
  public:
-  double x, y;
+  Real x, y;
   Vector2() : x(0), y(0) {}
-  Vector2(double x, double y) : x(x), y(y) { assert(!hasNaNs()); }
+  Vector2(Real x, Real y) : x(x), y(y) { assert(!hasNaNs()); }
 
   // Copy constructor
   Vector2(const Vector2& other) : x(other.x), y(other.y) {}
@@ -38,14 +40,14 @@ class Vector2 {
 
   bool hasNaNs() { return std::isnan(x) || std::isnan(y); }
 
-  double magnitude() const { return std::sqrt(magnitudeSquared()); }
-  double magnitudeSquared() const { return x * x + y * y; }
+  Real magnitude() const { return std::sqrt(magnitudeSquared()); }
+  Real magnitudeSquared() const { return x * x + y * y; }
 
   void normalize() { *this / magnitude(); }
   Vector2 normalized() const { return Vector2(*this / magnitude()); }
 
   Vector2 reflect(const Vector2& normal) { return *this - 2 * dot(*this, normal) * normal; }
-  Vector2 refract(const Vector2& normal, double refractiveRatio) {
+  Vector2 refract(const Vector2& normal, Real refractiveRatio) {
     auto cosTheta = dot(-*this, normal);
     Vector2 outParallel = refractiveRatio * (*this + cosTheta * normal);
     Vector2 outPerp = -std::sqrt(1.0 - outParallel.magnitudeSquared()) * normal;
@@ -54,13 +56,13 @@ class Vector2 {
 
   // Member functions are implicitly inline.
   Vector2 operator-() const { return Vector2(-x, -y); }
-  double operator[](int i) const {
+  Real operator[](int i) const {
     if (i == 0)
       return x;
     else
       return y;
   }
-  double& operator[](int i) {
+  Real& operator[](int i) {
     if (i == 0)
       return x;
     else
@@ -78,7 +80,7 @@ class Vector2 {
     y -= rhs.y;
     return *this;
   }
-  Vector2& operator*=(const double value) {
+  Vector2& operator*=(const Real value) {
     x *= value;
     y *= value;
     return *this;
@@ -88,7 +90,7 @@ class Vector2 {
     y *= rhs.y;
     return *this;
   }
-  Vector2& operator/=(const double value) {
+  Vector2& operator/=(const Real value) {
     assert(!hasNaNs());
     return *this *= 1 / value;
   }
@@ -97,18 +99,18 @@ class Vector2 {
   Vector2 operator+(const Vector2& rhs) const { return Vector2(x + rhs.x, y + rhs.y); }
   Vector2 operator-(const Vector2& rhs) const { return Vector2(x - rhs.x, y - rhs.y); }
   Vector2 operator*(const Vector2& rhs) const { return Vector2(x * rhs.x, y * rhs.y); }
-  Vector2 operator*(double scalar) const { return Vector2(x * scalar, y * scalar); }
-  Vector2 operator/(double scalar) const {
+  Vector2 operator*(Real scalar) const { return Vector2(x * scalar, y * scalar); }
+  Vector2 operator/(Real scalar) const {
     assert(scalar != 0);
-    double fraction = 1 / scalar;
+    Real fraction = 1 / scalar;
     return Vector2(x * fraction, y * fraction);
   }
 
   // Friend functions are implicitly inline.
-  friend Vector2 operator*(double scalar, const Vector2& rhs) { return rhs * scalar; }
+  friend Vector2 operator*(Real scalar, const Vector2& rhs) { return rhs * scalar; }
   friend std::ostream& operator<<(std::ostream& out, const Vector2& v) { return out << v.x << ' ' << v.y; }
-  friend double dot(const Vector2& lhs, const Vector2& rhs);
-  friend double absDot(const Vector2& lhs, const Vector2& rhs) { return std::abs(dot(lhs, rhs)); }
+  friend Real dot(const Vector2& lhs, const Vector2& rhs);
+  friend Real absDot(const Vector2& lhs, const Vector2& rhs) { return std::abs(dot(lhs, rhs)); }
 };
-double dot(const Vector2& lhs, const Vector2& rhs) { return lhs.x * rhs.x + lhs.y * rhs.y; }
+Real dot(const Vector2& lhs, const Vector2& rhs) { return lhs.x * rhs.x + lhs.y * rhs.y; }
 #endif
\ No newline at end of file
@@ -4,14 +4,16 @@
 #include <cmath>
 #include <iostream>
 
+#include "Math.hpp"
+
 class Normal3;
 class Point3;
 
 class Vector3 {
  public:
-  double x, y, z;  // Scalar components of the vector.
+  Real x, y, z;  // Scalar components of the vector.
   Vector3() : x(0), y(0), z(0) {}
-  Vector3(double x, double y, double z) : x(x), y(y), z(z) {
+  Vector3(Real x, Real y, Real z) : x(x), y(y), z(z) {
     // assert(!hasNaNs());
   }
   // Copy constructor
@@ -47,14 +49,14 @@ class Vector3 {
   bool hasNaNs() { return std::isnan(x) || std::isnan(y) || std::isnan(z); }
 
   // Member functions are implicitly inline.
-  double magnitude() const { return std::sqrt(magnitudeSquared()); }
-  double magnitudeSquared() const { return x * x + y * y + z * z; }
+  Real magnitude() const { return std::sqrt(magnitudeSquared()); }
+  Real magnitudeSquared() const { return x * x + y * y + z * z; }
 
   void normalize() { *this /= magnitude(); }
   Vector3 normalized() const { return Vector3(*this / magnitude()); }
 
   Vector3 reflect(const Vector3& normal) const { return *this - 2 * dot(*this, normal) * normal; }
-  Vector3 refract(const Vector3& normal, double refractiveRatio) const {
+  Vector3 refract(const Vector3& normal, Real refractiveRatio) const {
     const auto cosTheta = dot(-*this, normal);
     const Vector3 outParallel = refractiveRatio * (*this + cosTheta * normal);
     const Vector3 outPerp = -std::sqrt(1.0 - outParallel.magnitudeSquared()) * normal;
@@ -62,12 +64,12 @@ class Vector3 {
   }
 
   // Member access operators
-  double operator[](int i) const {
+  Real operator[](int i) const {
     if (i == 0) return x;
     if (i == 1) return y;
     return z;
   }
-  double& operator[](int i) {
+  Real& operator[](int i) {
     if (i == 0) return x;
     if (i == 1) return y;
     return z;
@@ -92,13 +94,13 @@ class Vector3 {
     z *= rhs.z;
     return *this;
   }
-  Vector3& operator*=(const double scalar) {
+  Vector3& operator*=(const Real scalar) {
     x *= scalar;
     y *= scalar;
     z *= scalar;
     return *this;
   }
-  Vector3& operator/=(const double scalar) {
+  Vector3& operator/=(const Real scalar) {
     assert(!hasNaNs());
     return *this *= (1.f / scalar);
   }
@@ -108,26 +110,26 @@ class Vector3 {
   Vector3 operator+(const Vector3& rhs) const { return Vector3(x + rhs.x, y + rhs.y, z + rhs.z); }
   Vector3 operator-(const Vector3& rhs) const { return Vector3(x - rhs.x, y - rhs.y, z - rhs.z); }
   Vector3 operator*(const Vector3& rhs) const { return Vector3(x * rhs.x, y * rhs.y, z * rhs.z); }
-  Vector3 operator*(double scalar) const { return Vector3(x * scalar, y * scalar, z * scalar); }
-  Vector3 operator/(double scalar) const {
+  Vector3 operator*(Real scalar) const { return Vector3(x * scalar, y * scalar, z * scalar); }
+  Vector3 operator/(Real scalar) const {
     assert(scalar != 0);
-    double fraction = 1.f / scalar;
+    Real fraction = 1.f / scalar;
     return Vector3(x * fraction, y * fraction, z * fraction);
   }
 
-  double minComponent() const { return std::min(x, std::min(y, z)); }
-  double maxComponent() const { return std::max(x, std::max(y, z)); }
+  Real minComponent() const { return std::min(x, std::min(y, z)); }
+  Real maxComponent() const { return std::max(x, std::max(y, z)); }
 
   // Returns the index of the largest component.
   int maxDimension() { return (x > y) ? ((x > z) ? 0 : 2) : ((y > z) ? 1 : 2); }
 
   // Friend functions are implicitly inline.
-  friend Vector3 operator*(double scalar, const Vector3& rhs);
+  friend Vector3 operator*(Real scalar, const Vector3& rhs);
   friend std::ostream& operator<<(std::ostream& out, const Vector3& vector) {
     return out << vector.x << ' ' << vector.y << ' ' << vector.z;
   }
-  friend double dot(const Vector3& lhs, const Vector3& rhs);
-  friend double absDot(const Vector3& lhs, const Vector3& rhs) { return std::abs(dot(lhs, rhs)); }
+  friend Real dot(const Vector3& lhs, const Vector3& rhs);
+  friend Real absDot(const Vector3& lhs, const Vector3& rhs) { return std::abs(dot(lhs, rhs)); }
   friend Vector3 abs(const Vector3& vec) { return Vector3(std::abs(vec.x), std::abs(vec.y), std::abs(vec.z)); }
   friend Vector3 cross(const Vector3& lhs, const Vector3& rhs);
   friend Vector3 min(const Vector3& lhs, const Vector3& rhs) {
@@ -139,8 +141,8 @@ class Vector3 {
 };
 
 // Friend function definitions.
-Vector3 operator*(double scalar, const Vector3& rhs) { return rhs * scalar; }
-double dot(const Vector3& lhs, const Vector3& rhs) { return lhs.x * rhs.x + lhs.y * rhs.y + lhs.z * rhs.z; }
+Vector3 operator*(Real scalar, const Vector3& rhs) { return rhs * scalar; }
+Real dot(const Vector3& lhs, const Vector3& rhs) { return lhs.x * rhs.x + lhs.y * rhs.y + lhs.z * rhs.z; }
 Vector3 cross(const Vector3& lhs, const Vector3& rhs) {
   return Vector3(lhs.y * rhs.z - lhs.z * rhs.y, lhs.z * rhs.x - lhs.x * rhs.z, lhs.x * rhs.y - lhs.y * rhs.x);
 }
@@ -148,10 +150,10 @@ Vector3 cross(const Vector3& lhs, const Vector3& rhs) {
 // Member functions defined in the class body are implicitly inline.
 
 struct UV {
-  double u;
-  double v;
+  Real u;
+  Real v;
   UV() : u(0), v(0) {}
-  UV(double u, double v) : u(u), v(v) {}
+  UV(Real u, Real v) : u(u), v(v) {}
 };
 
 class Color {
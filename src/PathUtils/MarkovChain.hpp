@@ -1,53 +1,124 @@
 #ifndef MARKOV_CHAIN_HPP
 #define MARKOV_CHAIN_HPP
 
+#include <cmath>
+#include <cstdint>
 #include <vector>
 
+#include "../Core/Serialization.hpp"
 #include "../Math/Random.hpp"
 #include "PathContribution.hpp"
 
+// Primary sample space state of a Kelemen style Markov chain. Mutations are lazy: startIteration() only advances the
+// clock, and a sample is brought up to date when the path reads it, by drawing it anew after a large step or by
+// applying the small steps it missed. A step therefore costs as many samples as the path consumes, not numStates.
+// Samples read by a rejected proposal are restored from their backup.
 struct MarkovChain {
  private:
-  int numStates;
-  int maxEvents;
-  std::vector<double> sampleSpace;
+  struct PrimarySample {
+    double value;
+    uint64_t modified;  // iteration of the last change
+    double backupValue;
+    uint64_t backupModified;
+  };
+
+  double pixelStepSize;
+  std::vector<PrimarySample> samples;
+  std::vector<int> touched;  // samples changed by the current iteration
+  uint64_t iteration = 0;
+  uint64_t lastLargeStep = 0;
+  bool largeStep = false;
+
+  // Small step of the sample at index. The first two are the image plane position, the rest path vertices.
+  double perturb(int index, double value, RNG& rng) const {
+    if (index < 2) return perturb(value, pixelStepSize, 0.1, rng);
+    return perturb(value, 1.0 / 1024.0, 1.0 / 64.0, rng);
+  }
 
  public:
   PathContribution pathContribution;
 
-  MarkovChain(int numStates, int maxEvents) : numStates(numStates), maxEvents(maxEvents), pathContribution(maxEvents) {
-    sampleSpace.reserve(numStates);
-    for (int i = 0; i < numStates; i++) sampleSpace.push_back(Random::fraction());
+  // Draws every sample up front, so that a chain seeded from a stream reproduces the path the bootstrap traced from
+  // it. pixelStepSize is the smallest image plane perturbation, 2 / (imageHeight + imageWidth).
+  MarkovChain(int numStates, int maxEvents, double pixelStepSize, RNG& rng) :
+      pixelStepSize(pixelStepSize),
+      pathContribution(maxEvents) {
+    samples.reserve(numStates);
+    touched.reserve(numStates);
+    for (int i = 0; i < numStates; i++) samples.push_back(PrimarySample{Random::fraction(rng), 0, 0, 0});
   }
 
-  // Copy constructor
-  MarkovChain(const MarkovChain& other) : sampleSpace(other.sampleSpace), pathContribution(other.pathContribution) {}
-  // Move constructor
-  MarkovChain(MarkovChain&& other) :
-      sampleSpace(std::move(other.sampleSpace)),
-      pathContribution(std::move(other.pathContribution)) {}
-  // Copy assignment
-  MarkovChain& operator=(const MarkovChain& other) {
-    sampleSpace = other.sampleSpace;
-    pathContribution = other.pathContribution;
-    return *this;
+  int length() const { return samples.size(); }
+
+  void startIteration(bool isLargeStep) {
+    iteration++;
+    largeStep = isLargeStep;
+    touched.clear();
   }
-  // Move assignment
-  MarkovChain& operator=(MarkovChain&& other) {
-    sampleSpace = std::move(other.sampleSpace);
-    pathContribution = std::move(other.pathContribution);
-    return *this;
+
+  // The sample at index as of the current iteration.
+  double get(int index, RNG& rng) {
+    PrimarySample& sample = samples[index];
+    if (sample.modified == iteration) return sample.value;
+
+    sample.backupValue = sample.value;
+    sample.backupModified = sample.modified;
+    touched.push_back(index);
+
+    if (largeStep) {
+      sample.value = Random::fraction(rng);
+    } else {
+      // A sample untouched since before the last accepted large step is drawn as of that step, then gets one small
+      // step for every accepted iteration since, as an eager chain would have made.
+      if (sample.modified < lastLargeStep) {
+        sample.value = Random::fraction(rng);
+        sample.modified = lastLargeStep;
+      }
+      for (uint64_t step = sample.modified; step < iteration; step++) sample.value = perturb(index, sample.value, rng);
+    }
+    sample.modified = iteration;
+    return sample.value;
   }
 
-  double& operator[](int index) { return sampleSpace[index]; }
-  double operator[](int index) const { return sampleSpace[index]; }
+  void accept() {
+    if (largeStep) lastLargeStep = iteration;
+  }
 
-  int length() const { return sampleSpace.size(); }
+  // Rejected iterations do not count as steps.
+  void reject() {
+    for (const int index : touched) {
+      samples[index].value = samples[index].backupValue;
+      samples[index].modified = samples[index].backupModified;
+    }
+    touched.clear();
+    iteration--;
+  }
+
+  void save(std::ostream& out) const {
+    Serialization::write<uint32_t>(out, samples.size());
+    Serialization::write(out, iteration);
+    Serialization::write(out, lastLargeStep);
+    for (const auto& sample : samples) {
+      Serialization::write(out, sample.value);
+      Serialization::write(out, sample.modified);
+    }
+    pathContribution.save(out);
+  }
+
+  // Expects a chain of the same length.
+  bool load(std::istream& in) {
+    uint32_t size;
+    if (!Serialization::read(in, size) || size != samples.size()) return false;
+    if (!Serialization::read(in, iteration) || !Serialization::read(in, lastLargeStep)) return false;
+    for (auto& sample : samples)
+      if (!Serialization::read(in, sample.value) || !Serialization::read(in, sample.modified)) return false;
+    return pathContribution.load(in);
+  }
 
   // primary space Markov chain
-  static inline double perturb(const double value, const double s1, const double s2) {
+  static inline double perturb(const double value, const double s1, const double s2, RNG& rng) {
     double result;
-    double randomValue = Random::fraction();
+    double randomValue = Random::fraction(rng);
     if (randomValue < 0.5) {
       randomValue = randomValue * 2.0;
       result = value + s2 * std::exp(-std::log(s2 / s1) * randomValue);
@@ -59,25 +130,6 @@ struct MarkovChain {
     }
     return result;
   }
-
-  MarkovChain largeStep() const {
-    MarkovChain result(numStates, maxEvents);
-    result.pathContribution = pathContribution;
-    return result;
-  }
-
-  MarkovChain mutate(int imageHeight, int imageWidth) const {
-    MarkovChain result(numStates, maxEvents);
-    result.pathContribution = pathContribution;
-
-    // pixel location
-    result.sampleSpace[0] = perturb(sampleSpace[0], 2.0 / double(imageHeight + imageWidth), 0.1);
-    result.sampleSpace[1] = perturb(sampleSpace[1], 2.0 / double(imageHeight + imageWidth), 0.1);
-
-    // the rest
-    for (int i = 2; i < numStates; i++) result.sampleSpace[i] = perturb(sampleSpace[i], 1.0 / 1024.0, 1.0 / 64.0);
-    return result;
-  }
 };
 
-#endif
\ No newline at end of file
+#endif
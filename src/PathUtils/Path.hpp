@@ -37,10 +37,10 @@ class Path {
   void add(const Vertex& vertex) { vertices.push_back(vertex); }
 
   Vertex& operator[](int index) { return vertices[index]; }
-  Vertex operator[](int index) const { return vertices[index]; }
+  const Vertex& operator[](int index) const { return vertices[index]; }
 
-  Vertex last() const { return vertices.back(); }
-  Vertex first() const { return vertices.front(); }
+  const Vertex& last() const { return vertices.back(); }
+  const Vertex& first() const { return vertices.front(); }
   std::vector<Vertex> firstN(int vertexCount) const {
     std::vector<Vertex> result;
     std::copy_n(vertices.begin(), vertexCount, std::back_inserter(result));
@@ -49,6 +49,8 @@ class Path {
 
   int length() const { return vertices.size(); }
   bool empty() const { return vertices.empty(); }
+  // Keeps the capacity, so a path reused for every sample stops allocating after the first one.
+  void clear() { vertices.clear(); }
   void removeLast() { vertices.pop_back(); }
   void append(const Path& path) { vertices.insert(vertices.end(), path.vertices.begin(), path.vertices.end()); }
   void reverse() { std::reverse(vertices.begin(), vertices.end()); }
@@ -2,6 +2,7 @@
 #define PATH_CONTRIBUTION_HPP
 
 #include "../Core/Image.hpp"
+#include "../Core/Serialization.hpp"
 #include "../Math/Vector3.hpp"
 #include "Contribution.hpp"
 
@@ -41,6 +42,36 @@ class PathContribution {
   Contribution operator[](int index) const { return contributions[index]; }
 
   void add(const Contribution& contrib) { contributions.push_back(contrib); }
+  void clear() {
+    contributions.clear();
+    scalarContrib = 0;
+  }
+
+  void save(std::ostream& out) const {
+    Serialization::write(out, scalarContrib);
+    Serialization::write<uint32_t>(out, contributions.size());
+    for (const auto& contribution : contributions) {
+      const double values[5] = {contribution.color.red, contribution.color.green, contribution.color.blue,
+                                contribution.x, contribution.y};
+      Serialization::write(out, values);
+    }
+  }
+
+  bool load(std::istream& in) {
+    uint32_t count;
+    if (!Serialization::read(in, scalarContrib) || !Serialization::read(in, count)) return false;
+    contributions.clear();
+    for (uint32_t i = 0; i < count; i++) {
+      double values[5];
+      if (!Serialization::read(in, values)) return false;
+      Contribution contribution;
+      contribution.color = Color(values[0], values[1], values[2]);
+      contribution.x = values[3];
+      contribution.y = values[4];
+      contributions.push_back(contribution);
+    }
+    return true;
+  }
 
   void accumulatePathContribution(const double scale, Image& image) {
     int imageWidth = image.getWidth();
@@ -0,0 +1,32 @@
+#ifndef PATH_VIEW_HPP
+#define PATH_VIEW_HPP
+
+#include "Path.hpp"
+#include "Vertex.hpp"
+
+// Full path of a bidirectional strategy without copying any vertex: the first numEyeVertices vertices of a camera
+// path followed by the first numLightVertices vertices of a light path, the latter read back to front.
+class PathView {
+ private:
+  const Path& cameraPath;
+  const Path& lightPath;
+  int numEyeVertices;
+  int numLightVertices;
+
+ public:
+  PathView(const Path& cameraPath, int numEyeVertices, const Path& lightPath, int numLightVertices) :
+      cameraPath(cameraPath),
+      lightPath(lightPath),
+      numEyeVertices(numEyeVertices),
+      numLightVertices(numLightVertices) {}
+
+  const Vertex& operator[](int index) const {
+    return index < numEyeVertices ? cameraPath[index] : lightPath[numEyeVertices + numLightVertices - 1 - index];
+  }
+
+  int length() const { return numEyeVertices + numLightVertices; }
+  int getNumEyeVertices() const { return numEyeVertices; }
+  int getNumLightVertices() const { return numLightVertices; }
+};
+
+#endif
@@ -3,46 +3,20 @@
 
 #include "MarkovChain.hpp"
 
+// Reads the samples of a chain in the current iteration, mutating each on first read. offset is the next sample to
+// read; the camera subpath starts at 0, the light subpath at numStatesSubpath.
 class PrimarySampleSpace {
-  std::vector<double> sampleSpace;
+  MarkovChain& chain;
+  RNG& rng;
 
  public:
-  mutable int offset;
-  PrimarySampleSpace() = default;
-  PrimarySampleSpace(int numStates) : offset(0) { sampleSpace.reserve(numStates); }
-  PrimarySampleSpace(const MarkovChain& markovChain) : offset(0) {
-    for (int i = 0; i < markovChain.length(); i++) sampleSpace.push_back(markovChain[i]);
-  }
-
-  // Copy constructor
-  PrimarySampleSpace(const PrimarySampleSpace& other) : sampleSpace(other.sampleSpace), offset(other.offset) {}
-  // Move constructor
-  PrimarySampleSpace(PrimarySampleSpace&& other) :
-      sampleSpace(std::move(other.sampleSpace)),
-      offset(std::move(other.offset)) {}
-  // Copy assignment
-  PrimarySampleSpace& operator=(const PrimarySampleSpace& other) {
-    sampleSpace = other.sampleSpace;
-    offset = other.offset;
-    return *this;
-  }
-  // Move assignment
-  PrimarySampleSpace& operator=(PrimarySampleSpace&& other) {
-    sampleSpace = std::move(other.sampleSpace);
-    offset = std::move(other.offset);
-    return *this;
-  }
+  int offset = 0;
+  PrimarySampleSpace(MarkovChain& chain, RNG& rng) : chain(chain), rng(rng) {}
 
-	// Every [] operation increments the offset for next sample
-  double& operator[](int index) {
-    offset++;
-    return sampleSpace[index];
-  }
-  
-	// Every [] operation increments the offset for next sample
-	double operator[](int index) const {
+  // Every [] operation increments the offset for next sample
+  double operator[](int index) {
     offset++;
-    return sampleSpace[index];
+    return chain.get(index, rng);
   }
 };
-#endif
\ No newline at end of file
+#endif
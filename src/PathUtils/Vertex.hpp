@@ -1,54 +1,43 @@
 #ifndef VERTEX_HPP
 #define VERTEX_HPP
 
+#include <cstdint>
+
 #include "../Core/SurfaceInteraction.hpp"
+#include "../Materials/Material.hpp"
 #include "../Math/Point3.hpp"
 
-class Vertex {
- public:
+// Plain data: the material is the index into the scene's material table (Scene::getMaterialById), so building and
+// copying paths touches no reference counts.
+struct Vertex {
+  static constexpr uint32_t noMaterial = UINT32_MAX;
+
   Point3 point;
   Vector3 normal;
-  SInteraction interaction;
-  std::shared_ptr<Material> materialPtr;
+  UV uv;
+  uint32_t materialId = noMaterial;
+  MaterialFlags materialFlags = MaterialFlags::None;  // copy of Material::flags
+  // Area densities of sampling this vertex by its own subpath (forward) and by the opposite one (reverse). Cached
+  // when the subpath is traced; the reverse density is only known once two more vertices follow.
+  double pdfForward = 0;
+  double pdfReverse = 0;
+
   Vertex() = default;
   Vertex(const Point3& point, const Vector3& normal) : point(point), normal(normal) {}
-  Vertex(const Point3& point, const Vector3& normal, const std::shared_ptr<Material> materialPtr) :
+  Vertex(const Point3& point, const Vector3& normal, const Material& material, uint32_t materialId) :
       point(point),
       normal(normal),
-      materialPtr(materialPtr) {}
-
-  // Copy constructor
-  Vertex(const Vertex& other) :
-      point(other.point),
-      normal(other.normal),
-      interaction(other.interaction),
-      materialPtr(other.materialPtr) {}
-  // Move constructor
-  Vertex(Vertex&& other) noexcept :
-      point(std::move(other.point)),
-      normal(std::move(other.normal)),
-      interaction(std::move(other.interaction)),
-      materialPtr(std::move(other.materialPtr)) {}
-  // Copy assignment
-  Vertex& operator=(const Vertex& other) {
-    point = other.point;
-    normal = other.normal;
-    interaction = other.interaction;
-    materialPtr = other.materialPtr;
-    return *this;
-  }
-  // Move assignment
-  Vertex& operator=(Vertex&& other) noexcept {
-    point = std::move(other.point);
-    normal = std::move(other.normal);
-    interaction = std::move(other.interaction);
-    materialPtr = std::move(other.materialPtr);
-    return *this;
-  }
+      materialId(materialId),
+      materialFlags(material.flags) {}
+  Vertex(const SInteraction& interaction, uint32_t materialId) :
+      point(interaction.point),
+      normal(interaction.normal),
+      uv(interaction.uv),
+      materialId(materialId),
+      materialFlags(interaction.materialPtr->flags) {}
 
-  Vertex(const SInteraction& interaction) : Vertex(interaction.point, interaction.normal, interaction.materialPtr) {
-    this->interaction = interaction;
-  }
+  bool hasMaterial() const { return materialId != noMaterial; }
+  bool isEmissive() const { return hasFlag(materialFlags, MaterialFlags::Emissive); }
 };
 
 #endif
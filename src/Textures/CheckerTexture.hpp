@@ -25,5 +25,14 @@ class CheckerTexture : public Texture {
     else
       return even->lookup(uv, point);
   }
+
+  TextureVariant toVariant() const override {
+    const TextureVariant evenVariant = even->toVariant();
+    const TextureVariant oddVariant = odd->toVariant();
+    const auto* evenColor = evenVariant.getIf<ConstantTexture>();
+    const auto* oddColor = oddVariant.getIf<ConstantTexture>();
+    if (evenColor && oddColor) return CheckerColors{evenColor->color, oddColor->color};
+    return TextureAdapter{this};
+  }
 };
 #endif
\ No newline at end of file
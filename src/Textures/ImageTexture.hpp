@@ -16,7 +16,7 @@ class ImageTexture : public Texture {
   unsigned char* dataPtr;
 
  public:
-  ImageTexture() : dataPtr(nullptr), width(0), height(0), bytesPerScanline(0) {}
+  ImageTexture() : width(0), height(0), bytesPerScanline(0), dataPtr(nullptr) {}
   ImageTexture(std::string fileName) {
     auto componentsPerPixel = bytesPerPixel;
     dataPtr = stbi_load(fileName.c_str(), &width, &height, &componentsPerPixel, componentsPerPixel);
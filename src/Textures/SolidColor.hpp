@@ -13,6 +13,7 @@ class SolidColor : public Texture {
   SolidColor(double red, double green, double blue) : SolidColor(Color(red, green, blue)) {}
 
   virtual Color lookup(const UV& coordinates, const Point3& point) const override { return color; }
+  TextureVariant toVariant() const override { return ConstantTexture{color}; }
 };
 
 #endif
\ No newline at end of file
@@ -5,11 +5,16 @@
 
 #include "../Math/Math.hpp"
 #include "../Math/Point3.hpp"
+#include "TextureVariant.hpp"
 
 class Texture {
  private:
  public:
   virtual Color lookup(const UV& coordinates, const Point3& point) const = 0;
+  // The same texture as a value the shading code can evaluate without virtual calls.
+  virtual TextureVariant toVariant() const { return TextureAdapter{this}; }
 };
 
+inline Color TextureAdapter::lookup(const UV& uv, const Point3& point) const { return texture->lookup(uv, point); }
+
 #endif
\ No newline at end of file
@@ -0,0 +1,65 @@
+#ifndef TEXTURE_VARIANT_HPP
+#define TEXTURE_VARIANT_HPP
+
+#include <cmath>
+#include <variant>
+
+#include "../Math/Math.hpp"
+#include "../Math/Point3.hpp"
+
+class Texture;
+
+// Closed set of textures that can be looked up without a virtual call. Texture::toVariant() maps a texture to one of
+// them; textures outside the set (image, Perlin) are reached through TextureAdapter.
+struct ConstantTexture {
+  Color color;
+  Color lookup(const UV& uv, const Point3& point) const { return color; }
+};
+
+// CheckerTexture over two solid colors.
+struct CheckerColors {
+  Color even;
+  Color odd;
+  Color lookup(const UV& uv, const Point3& point) const {
+    auto checkerSize = 10;
+    auto sines = std::sin(checkerSize * point.x);
+    sines *= std::sin(checkerSize * point.y);
+    sines *= std::sin(checkerSize * point.z);
+    return sines < 0 ? odd : even;
+  }
+};
+
+// Calls Texture::lookup(). The texture is owned elsewhere, usually by the material holding this variant.
+struct TextureAdapter {
+  const Texture* texture;
+  Color lookup(const UV& uv, const Point3& point) const;  // defined in Texture.hpp
+};
+
+class TextureVariant {
+ private:
+  std::variant<ConstantTexture, CheckerColors, TextureAdapter> texture;
+
+ public:
+  TextureVariant() : texture(ConstantTexture{Color(0, 0, 0)}) {}
+  TextureVariant(const ConstantTexture& texture) : texture(texture) {}
+  TextureVariant(const CheckerColors& texture) : texture(texture) {}
+  TextureVariant(const TextureAdapter& texture) : texture(texture) {}
+
+  template <typename T>
+  const T* getIf() const {
+    return std::get_if<T>(&texture);
+  }
+
+  Color lookup(const UV& uv, const Point3& point) const {
+    switch (texture.index()) {
+      case 0:
+        return std::get_if<0>(&texture)->lookup(uv, point);
+      case 1:
+        return std::get_if<1>(&texture)->lookup(uv, point);
+      default:
+        return std::get_if<2>(&texture)->lookup(uv, point);
+    }
+  }
+};
+
+#endif